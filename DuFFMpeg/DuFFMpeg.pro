@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -39,7 +39,27 @@ SOURCES += \
     rainboxui.cpp \
     frameless.cpp \
     ffmuxer.cpp \
-    ffobject.cpp
+    ffobject.cpp \
+    ffmemoryestimator.cpp \
+    ffprocessworker.cpp \
+    ffprogressparser.cpp \
+    ffoutputbuffer.cpp \
+    ffoutputparser.cpp \
+    logwidget.cpp \
+    fflogwriter.cpp \
+    ffprocessmonitor.cpp \
+    ffmetrics.cpp \
+    sparklinewidget.cpp \
+    ffmetricsexporter.cpp \
+    fftrace.cpp \
+    ffbenchmarkparser.cpp \
+    ffstartupprofile.cpp \
+    ffsequencescanner.cpp \
+    ffimageheader.cpp \
+    ffframefeeder.cpp \
+    ffcachewarmer.cpp \
+    ffbatchjob.cpp \
+    ffframemanifest.cpp
 
 HEADERS += \
     mainwindow.h \
@@ -55,7 +75,27 @@ HEADERS += \
     rainboxui.h \
     frameless.h \
     ffmuxer.h \
-    ffobject.h
+    ffobject.h \
+    ffmemoryestimator.h \
+    ffprocessworker.h \
+    ffprogressparser.h \
+    ffoutputbuffer.h \
+    ffoutputparser.h \
+    logwidget.h \
+    fflogwriter.h \
+    ffprocessmonitor.h \
+    ffmetrics.h \
+    sparklinewidget.h \
+    ffmetricsexporter.h \
+    fftrace.h \
+    ffbenchmarkparser.h \
+    ffstartupprofile.h \
+    ffsequencescanner.h \
+    ffimageheader.h \
+    ffframefeeder.h \
+    ffcachewarmer.h \
+    ffbatchjob.h \
+    ffframemanifest.h
 
 FORMS += \
     mainwindow.ui \
@@ -63,7 +103,8 @@ FORMS += \
     settingswidget.ui \
     queuewidget.ui \
     inputwidget.ui \
-    outputwidget.ui
+    outputwidget.ui \
+    logwidget.ui
 
 RESOURCES += \
     resources.qrc
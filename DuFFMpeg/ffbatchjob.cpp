@@ -0,0 +1,298 @@
+#include "ffbatchjob.h"
+
+#include <algorithm>
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFBatchJob::FFBatchJob(FFBatch batch, QObject *parent) : FFObject(parent)
+{
+    _batch = batch;
+    if (_batch.chunkSize < 1) _batch.chunkSize = 1;
+    if (_batch.processes < 1) _batch.processes = 1;
+    _converted = 0;
+    _kept = 0;
+    _failed = 0;
+    _retries = 0;
+    _stopping = false;
+    _join = nullptr;
+}
+
+QString FFBatchJob::segmentFileName(QString segmentsPath, int index, QString extension)
+{
+    return segmentsPath + "/segment_" + QString("%1").arg(index,5,10,QChar('0')) + "." + extension;
+}
+
+void FFBatchJob::start()
+{
+    QList<int> segments;
+    if (_batch.segmentsPath != "") segments = updateSegments();
+
+    for (int first = 0 ; first < _batch.frames.count() ; first += _batch.chunkSize)
+    {
+        Chunk chunk;
+        chunk.first = first;
+        chunk.count = qMin(_batch.chunkSize,_batch.frames.count() - first);
+        //the segments which have not changed are kept
+        if (_batch.segmentsPath != "" && !segments.contains(first / _batch.chunkSize))
+        {
+            _kept += chunk.count;
+            continue;
+        }
+        _pending << chunk;
+    }
+
+    if (_batch.segmentsPath != "")
+    {
+        emit debugInfo("Encoding " + QString::number(_pending.count()) + " segments of " + QString::number(_batch.chunkSize) + " frames, "
+                       + QString::number(_kept) + " frames kept from the previous encoding, " + QString::number(_batch.processes) + " processes at the same time");
+    }
+    else
+    {
+        emit debugInfo("Converting " + QString::number(_batch.frames.count()) + " frames in " + QString::number(_pending.count()) + " chunks, "
+                       + QString::number(_batch.processes) + " processes at the same time");
+    }
+    _timer.start();
+    launch();
+    if (_running.count() > 0) return;
+    if (_batch.segmentsPath != "" && _failed == 0) join();
+    else end(_failed > 0 ? 1 : 0);
+}
+
+void FFBatchJob::stop(int timeout)
+{
+    if (_stopping) return;
+    _stopping = true;
+    _pending.clear();
+
+    //the segments are joined quickly, but nothing is left to do once it's stopped
+    if (_join != nullptr) _join->kill();
+
+    //the processes finish the frames they have received
+    foreach(QProcess *process,_running.keys())
+    {
+        FFFrameFeeder *feeder = process->findChild<FFFrameFeeder *>();
+        if (feeder != nullptr) feeder->stop();
+    }
+    QTimer::singleShot(timeout,this,SLOT(kill()));
+}
+
+void FFBatchJob::processStarted()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+
+    FFFrameFeeder *feeder = process->findChild<FFFrameFeeder *>();
+    if (feeder != nullptr) feeder->start(process);
+
+    _processIds.insert(process,process->processId());
+    emit started(process->processId());
+}
+
+void FFBatchJob::processEnded()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    endChunk(process,process->exitStatus() == QProcess::NormalExit && process->exitCode() == 0);
+}
+
+void FFBatchJob::processError(QProcess::ProcessError e)
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    //the process will not emit finished if it could not start
+    if (e == QProcess::FailedToStart) endChunk(process,false);
+}
+
+void FFBatchJob::joinFinished()
+{
+    if (_join == nullptr) return;
+    int exitCode = 1;
+    if (_join->exitStatus() == QProcess::NormalExit && _join->error() != QProcess::FailedToStart) exitCode = _join->exitCode();
+    QString errors = QString::fromUtf8(_join->readAll()).trimmed();
+    if (_processIds.contains(_join)) emit processFinished(_processIds.take(_join));
+    _join->deleteLater();
+    _join = nullptr;
+
+    if (exitCode != 0 && !_stopping) emit output("The segments could not be joined to " + _batch.outputFileName + ".\n" + errors + "\n");
+    end(exitCode);
+}
+
+void FFBatchJob::joinError(QProcess::ProcessError e)
+{
+    //the process will not emit finished if it could not start
+    if (e == QProcess::FailedToStart) joinFinished();
+}
+
+void FFBatchJob::kill()
+{
+    foreach(QProcess *process,_running.keys()) process->kill();
+}
+
+void FFBatchJob::launch()
+{
+    while (!_stopping && _pending.count() > 0 && _running.count() < _batch.processes)
+    {
+        Chunk chunk = _pending.takeFirst();
+
+        QStringList arguments;
+        arguments << "-nostats" << "-y" << "-loglevel" << "error";
+        arguments << _batch.inputArguments << "-i" << "pipe:0";
+        arguments << _batch.outputArguments;
+        //each segment is a movie, which starts with a key frame
+        if (_batch.segmentsPath != "") arguments << segmentFileName(chunk);
+        else
+        {
+            //the numbering of the output follows the position of the frames
+            arguments << "-start_number" << QString::number(_batch.startNumber + chunk.first);
+            arguments << _batch.outputFileName;
+        }
+
+        QProcess *process = new QProcess(this);
+        process->setProgram(_batch.program);
+        process->setArguments(arguments);
+        //only errors are printed, they are read when the process has finished
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        FFFrameFeeder *feeder = new FFFrameFeeder(process);
+        feeder->setFrames(_batch.frames.mid(chunk.first,chunk.count),1,4);
+        connect(process,SIGNAL(started()),this,SLOT(processStarted()));
+        connect(process,SIGNAL(finished(int)),this,SLOT(processEnded()));
+        connect(process,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(processError(QProcess::ProcessError)));
+        _running.insert(process,chunk);
+        process->start(QIODevice::ReadWrite);
+    }
+}
+
+void FFBatchJob::endChunk(QProcess *process, bool ok)
+{
+    if (!_running.contains(process)) return;
+    Chunk chunk = _running.take(process);
+    if (_processIds.contains(process)) emit processFinished(_processIds.take(process));
+    QString errors = QString::fromUtf8(process->readAll()).trimmed();
+    process->deleteLater();
+
+    if (ok) _converted += chunk.count;
+    else if (_batch.segmentsPath != "")
+    {
+        //a movie with a missing segment is not usable, don't encode the others
+        _failed += chunk.count;
+        _pending.clear();
+        if (!_stopping) emit output("The segment of frames " + QString::number(chunk.first) + " to " + QString::number(chunk.first + chunk.count - 1) + " failed.\n" + errors + "\n");
+    }
+    else if (!_stopping && chunk.count > 1)
+    {
+        //retry the frames one by one, the others will be converted
+        emit output("Frames " + QString::number(_batch.startNumber + chunk.first) + " to " + QString::number(_batch.startNumber + chunk.first + chunk.count - 1) + " failed, retrying them one by one.\n" + errors + "\n");
+        for (int i = chunk.count - 1 ; i >= 0 ; i--)
+        {
+            Chunk frame;
+            frame.first = chunk.first + i;
+            frame.count = 1;
+            _pending.prepend(frame);
+        }
+        _retries += chunk.count;
+    }
+    else
+    {
+        _failed += chunk.count;
+        if (!_stopping) emit output("Frame " + QString::number(_batch.startNumber + chunk.first) + " (" + _batch.frames.at(chunk.first) + ") failed.\n" + errors + "\n");
+    }
+
+    FFProgress stats;
+    stats.frame = _kept + _converted;
+    double elapsed = _timer.elapsed() / 1000.0;
+    if (elapsed > 0) stats.fps = _converted / elapsed;
+    stats.end = _running.count() == 0 && (_pending.count() == 0 || _stopping);
+    emit progress(stats);
+
+    launch();
+
+    if (_running.count() > 0) return;
+    if (_batch.segmentsPath != "" && _failed == 0 && !_stopping) join();
+    else end(_failed > 0 ? 1 : 0);
+}
+
+QList<int> FFBatchJob::updateSegments()
+{
+    QFileInfo outputInfo(_batch.outputFileName);
+    QDir().mkpath(_batch.segmentsPath);
+    QString manifestFileName = _batch.segmentsPath + "/manifest.json";
+
+    //if the settings change, nothing can be kept
+    QString signature = QStringList(_batch.inputArguments + _batch.outputArguments).join(" ");
+    _manifest = FFFrameManifest::scan(_batch.frames,signature,_batch.chunkSize);
+    QList<int> segments = _manifest.changedSegments(FFFrameManifest::load(manifestFileName));
+
+    //segments removed since the previous encoding
+    for (int segment = 0 ; segment < _manifest.segmentCount() ; segment++)
+    {
+        if (segments.contains(segment)) continue;
+        if (!QFile::exists(segmentFileName(_batch.segmentsPath,segment,outputInfo.suffix()))) segments << segment;
+    }
+    std::sort(segments.begin(),segments.end());
+
+    //the manifest is valid only once all the segments have been encoded
+    QFile::remove(manifestFileName);
+
+    emit debugInfo(QString::number(segments.count()) + " of " + QString::number(_manifest.segmentCount()) + " segments of " + outputInfo.fileName() + " to encode, "
+                   + QString::number(_batch.chunkSize) + " frames each");
+    return segments;
+}
+
+QString FFBatchJob::segmentFileName(const Chunk &chunk)
+{
+    return segmentFileName(_batch.segmentsPath,chunk.first / _batch.chunkSize,QFileInfo(_batch.outputFileName).suffix());
+}
+
+void FFBatchJob::join()
+{
+    //all the segments, the kept ones and the new ones, relative to the list
+    QString list = "ffconcat version 1.0\n";
+    QString extension = QFileInfo(_batch.outputFileName).suffix();
+    for (int index = 0 ; index * _batch.chunkSize < _batch.frames.count() ; index++)
+    {
+        list += "file '" + QFileInfo(segmentFileName(_batch.segmentsPath,index,extension)).fileName() + "'\n";
+    }
+    QString listFileName = _batch.segmentsPath + "/segments.ffconcat";
+    QFile listFile(listFileName);
+    if (!listFile.open(QIODevice::WriteOnly))
+    {
+        emit output("Cannot write the list of segments " + listFileName + "\n");
+        end(1);
+        return;
+    }
+    listFile.write(list.toUtf8());
+    listFile.close();
+
+    QStringList arguments;
+    arguments << "-nostats" << "-y" << "-loglevel" << "error";
+    arguments << "-f" << "concat" << "-safe" << "0" << "-i" << QDir::toNativeSeparators(listFileName);
+    arguments << "-map" << "0" << "-c" << "copy";
+    //keep the muxer of the output
+    int muxerIndex = _batch.outputArguments.indexOf("-f");
+    if (muxerIndex >= 0 && muxerIndex < _batch.outputArguments.count() - 1) arguments << "-f" << _batch.outputArguments.at(muxerIndex + 1);
+    arguments << _batch.outputFileName;
+
+    emit debugInfo("Joining the segments to " + _batch.outputFileName);
+
+    _join = new QProcess(this);
+    _join->setProgram(_batch.program);
+    _join->setArguments(arguments);
+    _join->setProcessChannelMode(QProcess::MergedChannels);
+    connect(_join,SIGNAL(started()),this,SLOT(processStarted()));
+    connect(_join,SIGNAL(finished(int)),this,SLOT(joinFinished()));
+    connect(_join,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(joinError(QProcess::ProcessError)));
+    _join->start(QIODevice::ReadOnly);
+}
+
+void FFBatchJob::end(int exitCode)
+{
+    //the segments of a successful encoding are kept for the next one
+    if (_batch.segmentsPath != "" && exitCode == 0 && !_stopping) _manifest.save(_batch.segmentsPath + "/manifest.json");
+
+    double elapsed = _timer.elapsed() / 1000.0;
+    emit debugInfo("Conversion finished: " + QString::number(_converted) + " frames converted, " + QString::number(_kept) + " kept, " + QString::number(_failed) + " failed, "
+                   + QString::number(_retries) + " retried one by one, in " + QString::number(elapsed,'f',1) + " s");
+    emit finished(exitCode);
+}
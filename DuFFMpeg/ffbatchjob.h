@@ -0,0 +1,180 @@
+#ifndef FFBATCHJOB_H
+#define FFBATCHJOB_H
+
+#include "ffobject.h"
+
+#include <QProcess>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMetaType>
+
+#include "ffframefeeder.h"
+#include "ffprogressparser.h"
+#include "ffframemanifest.h"
+
+/**
+ * @brief The FFBatch struct A conversion of an image sequence split by frames:
+ * to another image sequence, or to a movie encoded by segments which are joined at the end
+ */
+struct FFBatch
+{
+    QString program;
+    /**
+     * @brief inputArguments The arguments before the input, which is read on stdin (image2pipe)
+     */
+    QStringList inputArguments;
+    /**
+     * @brief outputArguments The arguments of the output, without the start number and the file name
+     */
+    QStringList outputArguments;
+    /**
+     * @brief outputFileName The name of the output sequence, with the FFmpeg %0Nd convention, or of the movie
+     */
+    QString outputFileName;
+    /**
+     * @brief frames The input frames, in order
+     */
+    QStringList frames;
+    /**
+     * @brief startNumber The number of the output of the first frame
+     */
+    int startNumber = 0;
+    /**
+     * @brief chunkSize The number of frames converted by each process
+     */
+    int chunkSize = 1;
+    /**
+     * @brief processes The number of processes running at the same time
+     */
+    int processes = 1;
+    /**
+     * @brief segmentsPath When not empty, the output is a movie: each chunk is a segment encoded in this folder,
+     * starting with a key frame, and the segments are joined to the output with stream copy.
+     * Only the segments containing frames which have changed since the previous encoding are encoded.
+     */
+    QString segmentsPath;
+};
+Q_DECLARE_METATYPE(FFBatch)
+
+/**
+ * @brief The FFBatchJob class Converts an image sequence to another image sequence with several FFmpeg processes at the same time.
+ * As each frame is independent, the frames are split in chunks, each chunk converted by its own process, its frames sent on stdin.
+ * When a chunk fails, its frames are retried one by one, so only the frames which really fail are missing.
+ * A movie can be encoded the same way by segments: only the segments containing changed frames are encoded again,
+ * and joined to the ones kept from the previous encoding.
+ * It lives in the thread of a process worker, which sends its signals with the id of the job.
+ */
+class FFBatchJob : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFBatchJob(FFBatch batch, QObject *parent = nullptr);
+
+    void start();
+    /**
+     * @brief stop Stops launching new chunks, and lets the running ones finish the frames they have, killing them after the timeout
+     */
+    void stop(int timeout);
+    /**
+     * @brief segmentFileName The path of a segment of a movie
+     * @param segmentsPath The folder of the segments
+     * @param index The index of the segment
+     * @param extension The extension of the movie
+     */
+    static QString segmentFileName(QString segmentsPath, int index, QString extension);
+
+signals:
+    /**
+     * @brief started Emitted each time a process has started
+     */
+    void started(qint64 pid);
+    /**
+     * @brief processFinished Emitted each time a process has finished, before finished() for the last one
+     */
+    void processFinished(qint64 pid);
+    void progress(FFProgress progress);
+    /**
+     * @brief output Emitted with the errors of the failed processes
+     */
+    void output(QString output);
+    /**
+     * @brief finished Emitted when all the chunks have been converted
+     * @param exitCode 0 if all the frames have been converted
+     */
+    void finished(int exitCode);
+    void debugInfo(QString log);
+
+private slots:
+    void processStarted();
+    void processEnded();
+    void processError(QProcess::ProcessError e);
+    void joinFinished();
+    void joinError(QProcess::ProcessError e);
+    void kill();
+
+private:
+    /**
+     * @brief The Chunk struct Consecutive frames converted by the same process
+     */
+    struct Chunk {
+        int first;
+        int count;
+    };
+
+    FFBatch _batch;
+    /**
+     * @brief _manifest The frames of a segmented encoding, saved in the segments folder when it succeeds
+     */
+    FFFrameManifest _manifest;
+    QList<Chunk> _pending;
+    QMap<QProcess *, Chunk> _running;
+    /**
+     * @brief _processIds The ids of the running processes, which can't be read anymore once they have finished
+     */
+    QMap<QProcess *, qint64> _processIds;
+    int _converted;
+    /**
+     * @brief _kept The number of frames in the segments kept from the previous encoding
+     */
+    int _kept;
+    int _failed;
+    int _retries;
+    bool _stopping;
+    QElapsedTimer _timer;
+    /**
+     * @brief _join The process joining the segments
+     */
+    QProcess *_join;
+    /**
+     * @brief launch Starts processes for the pending chunks, up to the maximum number of processes
+     */
+    void launch();
+    /**
+     * @brief endChunk Handles a process which has finished
+     */
+    void endChunk(QProcess *process, bool ok);
+    /**
+     * @brief updateSegments Compares the frames with the manifest of the previous encoding to select the segments to encode.
+     * All the frames are read: it's done in the thread of the job, not to block the UI
+     * @return The indices of the segments to encode
+     */
+    QList<int> updateSegments();
+    /**
+     * @brief segmentFileName The path of the segment containing the chunk
+     */
+    QString segmentFileName(const Chunk &chunk);
+    /**
+     * @brief join Concatenates the segments to the output, once they are all encoded
+     */
+    void join();
+    /**
+     * @brief end Emits the report and finished()
+     */
+    void end(int exitCode);
+};
+
+#endif // FFBATCHJOB_H
@@ -0,0 +1,79 @@
+#include "ffbenchmarkparser.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFBenchmarkParser::FFBenchmarkParser(QObject *parent) : FFObject(parent)
+{
+
+}
+
+bool FFBenchmarkParser::addLine(const QString &line)
+{
+    //quick check before the regular expressions, most lines are not benchmarks
+    if (!line.startsWith("bench:")) return false;
+
+    QRegularExpressionMatch match = FFOutputParser::regExp(FFOutputParser::BenchmarkStage).match(line);
+    if (match.hasMatch())
+    {
+        FFBenchmarkStage stage = _benchmark.stages.value(match.captured(4));
+        stage.userTime += match.captured(1).toLongLong();
+        stage.systemTime += match.captured(2).toLongLong();
+        stage.realTime += match.captured(3).toLongLong();
+        stage.count++;
+        _benchmark.stages.insert(match.captured(4),stage);
+        return true;
+    }
+
+    match = FFOutputParser::regExp(FFOutputParser::BenchmarkTimes).match(line);
+    if (match.hasMatch())
+    {
+        _benchmark.userTime = match.captured(1).toDouble();
+        _benchmark.systemTime = match.captured(2).toDouble();
+        _benchmark.realTime = match.captured(3).toDouble();
+        _benchmark.valid = true;
+        return true;
+    }
+
+    match = FFOutputParser::regExp(FFOutputParser::BenchmarkMemory).match(line);
+    if (match.hasMatch())
+    {
+        //in kB
+        _benchmark.maxMemory = match.captured(1).toLongLong() * 1024;
+        _benchmark.valid = true;
+        return true;
+    }
+
+    //another bench: line, from a version of FFmpeg we don't know
+    return true;
+}
+
+FFBenchmark FFBenchmarkParser::benchmark() const
+{
+    return _benchmark;
+}
+
+void FFBenchmarkParser::reset()
+{
+    _benchmark = FFBenchmark();
+}
+
+QString FFBenchmarkParser::report(const FFBenchmark &benchmark)
+{
+    QString r = "Process: user " + QString::number(benchmark.userTime,'f',3) + "s"
+            + " | system " + QString::number(benchmark.systemTime,'f',3) + "s"
+            + " | real " + QString::number(benchmark.realTime,'f',3) + "s"
+            + " | max memory " + QString::number(benchmark.maxMemory / 1024 / 1024) + " MB";
+
+    QMapIterator<QString, FFBenchmarkStage> i(benchmark.stages);
+    while (i.hasNext())
+    {
+        i.next();
+        r += "\n" + i.key() + ": user " + QString::number(i.value().userTime / 1000000.0,'f',3) + "s"
+                + " | system " + QString::number(i.value().systemTime / 1000000.0,'f',3) + "s"
+                + " | real " + QString::number(i.value().realTime / 1000000.0,'f',3) + "s"
+                + " (" + QString::number(i.value().count) + " calls)";
+    }
+    return r;
+}
@@ -0,0 +1,93 @@
+#ifndef FFBENCHMARKPARSER_H
+#define FFBENCHMARKPARSER_H
+
+#include "ffobject.h"
+
+#include <QMap>
+#include <QMetaType>
+
+#include "ffoutputparser.h"
+
+/**
+ * @brief The FFBenchmarkStage struct The time spent by FFmpeg in one stage of the encoding (decode_video, encode_video...)
+ */
+struct FFBenchmarkStage
+{
+    /**
+     * @brief userTime The CPU time spent in user mode, in microseconds
+     */
+    qint64 userTime = 0;
+    /**
+     * @brief systemTime The CPU time spent in the kernel, in microseconds
+     */
+    qint64 systemTime = 0;
+    /**
+     * @brief realTime The wall clock time, in microseconds
+     */
+    qint64 realTime = 0;
+    /**
+     * @brief count The number of times the stage has been run (usually, once per frame)
+     */
+    int count = 0;
+};
+
+/**
+ * @brief The FFBenchmark struct The stats reported by FFmpeg when using -benchmark and -benchmark_all
+ */
+struct FFBenchmark
+{
+    /**
+     * @brief valid True if FFmpeg has reported its stats
+     */
+    bool valid = false;
+    /**
+     * @brief userTime The CPU time used by the process in user mode, in seconds
+     */
+    double userTime = 0.0;
+    /**
+     * @brief systemTime The CPU time used by the process in the kernel, in seconds
+     */
+    double systemTime = 0.0;
+    /**
+     * @brief realTime The duration of the process, in seconds
+     */
+    double realTime = 0.0;
+    /**
+     * @brief maxMemory The peak resident memory of the process, in bytes
+     */
+    qint64 maxMemory = 0;
+    /**
+     * @brief stages The time spent in each stage, by name
+     */
+    QMap<QString, FFBenchmarkStage> stages;
+};
+Q_DECLARE_METATYPE(FFBenchmark)
+
+/**
+ * @brief The FFBenchmarkParser class Parses the "bench:" lines written on stderr by FFmpeg when using -benchmark or -benchmark_all,
+ * and sums the time spent in each stage.
+ */
+class FFBenchmarkParser : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFBenchmarkParser(QObject *parent = nullptr);
+
+    /**
+     * @brief addLine Parses a line of output
+     * @param line The line, without the line feed
+     * @return true if this was a benchmark line
+     */
+    bool addLine(const QString &line);
+    FFBenchmark benchmark() const;
+    void reset();
+    /**
+     * @brief report Formats the stats of a benchmark in a human readable table
+     */
+    static QString report(const FFBenchmark &benchmark);
+
+private:
+    FFBenchmark _benchmark;
+};
+
+#endif // FFBENCHMARKPARSER_H
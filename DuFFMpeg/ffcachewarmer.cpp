@@ -0,0 +1,62 @@
+#include "ffcachewarmer.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFCacheWarmer::FFCacheWarmer(QObject *parent) : FFObject(parent)
+{
+
+}
+
+void FFCacheWarmer::warm(QStringList files, qint64 budget)
+{
+#ifdef Q_OS_LINUX
+    qint64 total = 0;
+    int count = 0;
+    foreach(QString fileName,files)
+    {
+        if (total >= budget) break;
+        qint64 size = advise(fileName,budget - total,true);
+        if (size < 0) continue;
+        total += qMin(size,budget - total);
+        count++;
+    }
+    if (count > 0) emit debugInfo("Loading the next inputs in the cache: " + QString::number(count) + " files, " + QString::number(total/1024/1024) + " MB");
+#else
+    Q_UNUSED(files);
+    Q_UNUSED(budget);
+#endif
+}
+
+void FFCacheWarmer::release(QStringList files)
+{
+#ifdef Q_OS_LINUX
+    foreach(QString fileName,files) advise(fileName,0,false);
+#else
+    Q_UNUSED(files);
+#endif
+}
+
+qint64 FFCacheWarmer::advise(QString fileName, qint64 length, bool willNeed)
+{
+#ifdef Q_OS_LINUX
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+    qint64 size = file.size();
+    if (length <= 0 || length > size) length = size;
+    //the advice is kept by the kernel after the file is closed
+    posix_fadvise(file.handle(),0,length,willNeed ? POSIX_FADV_WILLNEED : POSIX_FADV_DONTNEED);
+    file.close();
+    return size;
+#else
+    Q_UNUSED(fileName);
+    Q_UNUSED(length);
+    Q_UNUSED(willNeed);
+    return -1;
+#endif
+}
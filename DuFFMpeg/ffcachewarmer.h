@@ -0,0 +1,45 @@
+#ifndef FFCACHEWARMER_H
+#define FFCACHEWARMER_H
+
+#include "ffobject.h"
+
+#include <QFile>
+#include <QStringList>
+
+/**
+ * @brief The FFCacheWarmer class Loads the inputs of the next items of the queue in the page cache while the current ones are encoding,
+ * and evicts the inputs of the finished items.
+ * It uses posix_fadvise (WILLNEED / DONTNEED): the kernel reads the files in the background, nothing is read in this process.
+ * It lives in its own thread, as opening files on a network share can block. It does nothing on other systems than Linux.
+ */
+class FFCacheWarmer : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFCacheWarmer(QObject *parent = nullptr);
+
+signals:
+    void debugInfo(QString log);
+
+public slots:
+    /**
+     * @brief warm Asks the kernel to read files in advance
+     * @param files The files, by priority
+     * @param budget The maximum number of bytes to read, the next files are ignored
+     */
+    void warm(QStringList files, qint64 budget);
+    /**
+     * @brief release Tells the kernel the files won't be read anymore, their pages can be evicted from the cache
+     */
+    void release(QStringList files);
+
+private:
+    /**
+     * @brief advise Calls posix_fadvise on a file
+     * @param length The number of bytes from the start of the file, 0 for the whole file
+     * @return The size of the file, -1 if it could not be opened
+     */
+    qint64 advise(QString fileName, qint64 length, bool willNeed);
+};
+
+#endif // FFCACHEWARMER_H
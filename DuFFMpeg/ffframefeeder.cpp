@@ -0,0 +1,279 @@
+#include "ffframefeeder.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+//the pipe is not filled with more than this, the frames are read only when FFmpeg is ready for them
+#define MAX_PENDING_BYTES 16*1024*1024
+
+FFFrameFeeder::FFFrameFeeder(QObject *parent) : FFObject(parent)
+{
+    _process = nullptr;
+    _completion = StableSize;
+    _timeout = 60;
+    _running = false;
+    _digits = 1;
+    _nextNumber = 0;
+    _fedFrames = 0;
+    _lastSize = -1;
+    _nextFrame = 0;
+    _threads = 4;
+    _depth = 16;
+    _hits = 0;
+    _misses = 0;
+    _waiting = false;
+    _depthSum = 0;
+    _stallTime = 0;
+    //created when feeding starts, in the thread of the process
+    _watcher = nullptr;
+    _pollTimer = nullptr;
+    _pool = nullptr;
+}
+
+void FFFrameFeeder::setSequence(QString fileName, int startNumber)
+{
+    //split the name around the last {###}
+    int open = fileName.lastIndexOf("{");
+    int close = fileName.lastIndexOf("}");
+    if (open < 0 || close < open)
+    {
+        _prefix = fileName;
+        _suffix = "";
+        _digits = 0;
+    }
+    else
+    {
+        _prefix = fileName.left(open);
+        _suffix = fileName.mid(close + 1);
+        _digits = close - open - 1;
+    }
+    _nextNumber = startNumber;
+}
+
+void FFFrameFeeder::setFrames(QStringList frames, int threads, int depth)
+{
+    _frames = frames;
+    _nextFrame = 0;
+    _threads = qMax(1,threads);
+    _depth = qMax(1,depth);
+}
+
+void FFFrameFeeder::setCompletion(FFFrameFeeder::Completion completion)
+{
+    _completion = completion;
+}
+
+void FFFrameFeeder::setTimeout(int timeout)
+{
+    _timeout = timeout;
+}
+
+int FFFrameFeeder::fedFrames() const
+{
+    return _fedFrames;
+}
+
+QString FFFrameFeeder::decoderName(QString extension)
+{
+    extension = extension.toLower();
+    if (extension == "tga") return "targa";
+    if (extension == "jpg" || extension == "jpeg") return "mjpeg";
+    if (extension == "tif" || extension == "tiff") return "tiff";
+    if (extension == "png") return "png";
+    if (extension == "dpx") return "dpx";
+    if (extension == "exr") return "exr";
+    return "";
+}
+
+void FFFrameFeeder::start(QProcess *process)
+{
+    _process = process;
+    _running = true;
+    _fedFrames = 0;
+    _lastSize = -1;
+    connect(_process,SIGNAL(bytesWritten(qint64)),this,SLOT(feed()));
+
+    if (_frames.count() > 0)
+    {
+        _pool = new QThreadPool(this);
+        _pool->setMaxThreadCount(_threads);
+        emit debugInfo("Prefetching " + QString::number(_frames.count()) + " frames with " + QString::number(_threads) + " threads, " + QString::number(_depth) + " frames in advance");
+        feed();
+        return;
+    }
+
+    _watcher = new QFileSystemWatcher(this);
+    connect(_watcher,SIGNAL(directoryChanged(QString)),this,SLOT(feed()));
+    _watcher->addPath(QFileInfo(_prefix).path());
+    _pollTimer = new QTimer(this);
+    _pollTimer->setInterval(1000);
+    connect(_pollTimer,SIGNAL(timeout()),this,SLOT(feed()));
+    _pollTimer->start();
+    _idleTimer.start();
+
+    emit debugInfo("Following the sequence " + _prefix + "{" + QString(_digits,'#') + "}" + _suffix + " from frame " + QString::number(_nextNumber));
+    feed();
+}
+
+void FFFrameFeeder::stop()
+{
+    if (!_running) return;
+    _running = false;
+    if (_pollTimer != nullptr) _pollTimer->stop();
+    if (_watcher != nullptr) _watcher->removePaths(_watcher->directories());
+    if (_process == nullptr) return;
+    disconnect(_process,SIGNAL(bytesWritten(qint64)),this,SLOT(feed()));
+    //the pending frames are written before the pipe is closed
+    if (_process->state() == QProcess::Running) _process->closeWriteChannel();
+}
+
+QString FFFrameFeeder::report() const
+{
+    int requests = _hits + _misses;
+    double hitRate = 0;
+    double depth = 0;
+    if (requests > 0)
+    {
+        hitRate = 100.0 * _hits / requests;
+        depth = double(_depthSum) / requests;
+    }
+    return QString::number(_fedFrames) + " frames sent, " + QString::number(hitRate,'f',1) + "% ready when needed, "
+            + "average queue depth " + QString::number(depth,'f',1) + "/" + QString::number(_depth)
+            + ", stalled " + QString::number(_stallTime / 1000.0,'f',2) + " s";
+}
+
+void FFFrameFeeder::feed()
+{
+    if (!_running || _process == nullptr) return;
+    if (_pool != nullptr)
+    {
+        feedList();
+        return;
+    }
+
+    while (_process->bytesToWrite() < MAX_PENDING_BYTES)
+    {
+        QString fileName = frameFileName(_nextNumber);
+        if (!isComplete(fileName)) break;
+
+        QFile frame(fileName);
+        if (!frame.open(QIODevice::ReadOnly)) break;
+        _process->write(frame.readAll());
+        frame.close();
+
+        _nextNumber++;
+        _fedFrames++;
+        _lastSize = -1;
+        _idleTimer.restart();
+    }
+
+    //the encoder is slower than the render: it's not waiting for a frame, the render may not be idle
+    if (_process->bytesToWrite() >= MAX_PENDING_BYTES)
+    {
+        _idleTimer.restart();
+        return;
+    }
+
+    //nothing written for too long: the render is finished (or has failed)
+    if (_idleTimer.elapsed() > qint64(_timeout) * 1000)
+    {
+        emit debugInfo("No new frame after " + QString::number(_timeout) + " seconds, the sequence ends at frame " + QString::number(_nextNumber - 1) + " (" + QString::number(_fedFrames) + " frames).");
+        stop();
+    }
+}
+
+QString FFFrameFeeder::frameFileName(int number)
+{
+    return _prefix + QString::number(number).rightJustified(_digits,'0') + _suffix;
+}
+
+bool FFFrameFeeder::isComplete(QString fileName)
+{
+    if (_completion == Sidecar) return QFile::exists(fileName + ".done");
+
+    QFileInfo info(fileName);
+    if (!info.exists()) return false;
+    //renderers write the frames in order
+    if (QFile::exists(frameFileName(_nextNumber + 1))) return true;
+
+    //the size must not change for a second
+    qint64 size = info.size();
+    if (size != _lastSize)
+    {
+        _lastSize = size;
+        _sizeTimer.start();
+        return false;
+    }
+    return size > 0 && _sizeTimer.elapsed() >= 1000;
+}
+
+void FFFrameFeeder::feedList()
+{
+    prefetch();
+
+    while (_reads.count() > 0 && _process->bytesToWrite() < MAX_PENDING_BYTES)
+    {
+        QFutureWatcher<QByteArray> *next = _reads.first();
+        if (!next->isFinished())
+        {
+            //the pipe wants a frame which is not read yet
+            if (!_waiting)
+            {
+                _misses++;
+                _waiting = true;
+            }
+            //FFmpeg has nothing left to decode
+            if (_process->bytesToWrite() == 0 && !_stallTimer.isValid()) _stallTimer.start();
+            return;
+        }
+
+        if (_stallTimer.isValid())
+        {
+            _stallTime += _stallTimer.elapsed();
+            _stallTimer.invalidate();
+        }
+        if (!_waiting) _hits++;
+        _waiting = false;
+        //the frames ready in memory
+        int ready = 0;
+        foreach(QFutureWatcher<QByteArray> *read,_reads) if (read->isFinished()) ready++;
+        _depthSum += ready;
+
+        QByteArray data = next->result();
+        if (data.isEmpty()) emit debugInfo("Cannot read the frame " + _frames.at(_nextFrame) + ", it is skipped.");
+        else _process->write(data);
+        _reads.removeFirst();
+        next->deleteLater();
+        _nextFrame++;
+        _fedFrames++;
+
+        prefetch();
+    }
+
+    if (_reads.count() == 0 && _nextFrame >= _frames.count())
+    {
+        emit debugInfo("Prefetching finished: " + report());
+        stop();
+    }
+}
+
+void FFFrameFeeder::prefetch()
+{
+    while (_reads.count() < _depth && _nextFrame + _reads.count() < _frames.count())
+    {
+        QFutureWatcher<QByteArray> *read = new QFutureWatcher<QByteArray>(this);
+        connect(read,SIGNAL(finished()),this,SLOT(feed()));
+        read->setFuture(QtConcurrent::run(_pool,&FFFrameFeeder::readFrame,_frames.at(_nextFrame + _reads.count())));
+        _reads << read;
+    }
+}
+
+QByteArray FFFrameFeeder::readFrame(QString fileName)
+{
+    QFile frame(fileName);
+    if (!frame.open(QIODevice::ReadOnly)) return QByteArray();
+    QByteArray data = frame.readAll();
+    frame.close();
+    return data;
+}
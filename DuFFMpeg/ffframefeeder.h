@@ -0,0 +1,169 @@
+#ifndef FFFRAMEFEEDER_H
+#define FFFRAMEFEEDER_H
+
+#include "ffobject.h"
+
+#include <QProcess>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+/**
+ * @brief The FFFrameFeeder class Writes the frames of an image sequence on the standard input of FFmpeg (image2pipe).
+ * It lives in the thread of the process worker, next to the process it feeds. It has two modes:
+ * - It follows a sequence which is still being rendered: the folder is watched, and each frame is sent, in order, as soon as it is complete.
+ * When no new frame comes before the timeout, the standard input is closed and FFmpeg finishes the encoding.
+ * - It prefetches a list of frames: a pool of threads reads the next frames in a bounded queue, so the latency of slow storage is hidden.
+ */
+class FFFrameFeeder : public FFObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief The Completion enum How to know that a frame has been completely written by the renderer
+     */
+    enum Completion {
+        /**
+         * @brief StableSize The size of the file has not changed for a second, or the next frame exists
+         */
+        StableSize,
+        /**
+         * @brief Sidecar A file with the same name and the .done extension has been written next to the frame
+         */
+        Sidecar
+    };
+    Q_ENUM(Completion)
+
+    explicit FFFrameFeeder(QObject *parent = nullptr);
+
+    /**
+     * @brief setSequence Sets the sequence to follow
+     * @param fileName The name of the sequence, with the {###} convention
+     * @param startNumber The number of the first frame
+     */
+    void setSequence(QString fileName, int startNumber);
+    /**
+     * @brief setFrames Sets the frames to prefetch and send, instead of following a sequence
+     * @param frames The files, in order
+     * @param threads The number of threads reading the files
+     * @param depth The maximum number of frames read in advance
+     */
+    void setFrames(QStringList frames, int threads, int depth);
+    void setCompletion(Completion completion);
+    /**
+     * @brief setTimeout Sets the delay after which the sequence is considered finished if no new frame comes
+     * @param timeout The delay in seconds
+     */
+    void setTimeout(int timeout);
+    /**
+     * @brief fedFrames The number of frames written to FFmpeg
+     */
+    int fedFrames() const;
+    /**
+     * @brief decoderName The FFmpeg decoder to use with image2pipe for an image format, which FFmpeg can't always detect
+     * @param extension The extension of the frames
+     * @return The name of the decoder, an empty string to let FFmpeg detect it
+     */
+    static QString decoderName(QString extension);
+    /**
+     * @brief report The statistics of the prefetching: hit rate, queue depth and stall time
+     */
+    QString report() const;
+
+signals:
+    void debugInfo(QString log);
+
+public slots:
+    /**
+     * @brief start Starts feeding a process which has started
+     */
+    void start(QProcess *process);
+    /**
+     * @brief stop Stops feeding and closes the standard input, FFmpeg finishes the encoding with the frames it has received
+     */
+    void stop();
+
+private slots:
+    /**
+     * @brief feed Writes the next frames which are complete, while the pipe is not full
+     */
+    void feed();
+
+private:
+    QProcess *_process;
+    QFileSystemWatcher *_watcher;
+    /**
+     * @brief _pollTimer Checks the sizes regularly, the watcher is not notified of all the writes (and does not work on all network shares)
+     */
+    QTimer *_pollTimer;
+    QElapsedTimer _idleTimer;
+    Completion _completion;
+    int _timeout;
+    bool _running;
+    QString _prefix;
+    QString _suffix;
+    int _digits;
+    int _nextNumber;
+    int _fedFrames;
+    /**
+     * @brief _lastSize The size of the next frame at the previous check, to know if it's still being written
+     */
+    qint64 _lastSize;
+    QElapsedTimer _sizeTimer;
+    /**
+     * @brief frameFileName The file name of a frame
+     */
+    QString frameFileName(int number);
+    /**
+     * @brief isComplete Checks if the next frame has been completely written
+     */
+    bool isComplete(QString fileName);
+    /**
+     * @brief feedList Sends the prefetched frames, in list mode
+     */
+    void feedList();
+    /**
+     * @brief prefetch Starts reading the next frames, until the queue is full
+     */
+    void prefetch();
+    /**
+     * @brief readFrame Reads a file, in a thread of the pool
+     */
+    static QByteArray readFrame(QString fileName);
+
+    //list mode
+    QStringList _frames;
+    /**
+     * @brief _nextFrame The index of the next frame to write
+     */
+    int _nextFrame;
+    int _threads;
+    int _depth;
+    QThreadPool *_pool;
+    /**
+     * @brief _reads The frames being read or waiting to be written, in order
+     */
+    QList<QFutureWatcher<QByteArray> *> _reads;
+    /**
+     * @brief _hits The number of frames which were ready when the pipe needed them
+     */
+    int _hits;
+    int _misses;
+    /**
+     * @brief _waiting True when the next frame has already been counted as a miss
+     */
+    bool _waiting;
+    qint64 _depthSum;
+    /**
+     * @brief _stallTimer Runs while FFmpeg has nothing left to read and waits for the storage
+     */
+    QElapsedTimer _stallTimer;
+    qint64 _stallTime;
+};
+
+#endif // FFFRAMEFEEDER_H
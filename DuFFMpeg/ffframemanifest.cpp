@@ -0,0 +1,129 @@
+#include "ffframemanifest.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+bool FFFrame::operator==(const FFFrame &other) const
+{
+    return path == other.path && size == other.size && modified == other.modified;
+}
+
+bool FFFrame::operator!=(const FFFrame &other) const
+{
+    return !(*this == other);
+}
+
+FFFrameManifest FFFrameManifest::scan(const QStringList &files, QString signature, int segmentLength)
+{
+    FFFrameManifest manifest;
+    manifest.signature = signature;
+    manifest.segmentLength = segmentLength;
+
+    QList<QFileInfo> infos = FFSequenceScanner::stat(files);
+    manifest.frames.reserve(infos.count());
+    for (int i = 0 ; i < infos.count() ; i++)
+    {
+        FFFrame frame;
+        frame.path = files.at(i);
+        if (infos.at(i).exists())
+        {
+            frame.size = infos.at(i).size();
+            frame.modified = infos.at(i).lastModified().toMSecsSinceEpoch();
+        }
+        manifest.frames << frame;
+    }
+    return manifest;
+}
+
+FFFrameManifest FFFrameManifest::load(QString fileName)
+{
+    FFFrameManifest manifest;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return manifest;
+    QJsonObject manifestObj = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+
+    manifest.signature = manifestObj.value("signature").toString();
+    manifest.segmentLength = manifestObj.value("segmentLength").toInt();
+    foreach(QJsonValue frameValue,manifestObj.value("frames").toArray())
+    {
+        QJsonObject frameObj = frameValue.toObject();
+        FFFrame frame;
+        frame.path = frameObj.value("path").toString();
+        //qint64 values are stored as strings, a double can't keep them
+        frame.size = frameObj.value("size").toString().toLongLong();
+        frame.modified = frameObj.value("modified").toString().toLongLong();
+        manifest.frames << frame;
+    }
+
+    return manifest;
+}
+
+bool FFFrameManifest::save(QString fileName) const
+{
+    QJsonArray framesArray;
+    foreach(FFFrame frame,frames)
+    {
+        QJsonObject frameObj;
+        frameObj.insert("path",frame.path);
+        frameObj.insert("size",QString::number(frame.size));
+        frameObj.insert("modified",QString::number(frame.modified));
+        framesArray.append(frameObj);
+    }
+
+    QJsonObject manifestObj;
+    manifestObj.insert("signature",signature);
+    manifestObj.insert("segmentLength",segmentLength);
+    manifestObj.insert("frames",framesArray);
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(manifestObj).toJson(QJsonDocument::Compact));
+    file.close();
+    return true;
+}
+
+int FFFrameManifest::segmentCount() const
+{
+    if (segmentLength < 1) return 0;
+    return (frames.count() + segmentLength - 1) / segmentLength;
+}
+
+QString FFFrameManifest::key() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(signature.toUtf8());
+    foreach(FFFrame frame,frames)
+    {
+        hash.addData("\n");
+        hash.addData(frame.path.toUtf8());
+        hash.addData("|" + QByteArray::number(frame.size) + "|" + QByteArray::number(frame.modified));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QList<int> FFFrameManifest::changedSegments(const FFFrameManifest &previous) const
+{
+    QList<int> segments;
+    //other settings, or other boundaries: nothing can be kept
+    bool all = previous.signature != signature || previous.segmentLength != segmentLength;
+
+    for (int segment = 0 ; segment < segmentCount() ; segment++)
+    {
+        int first = segment * segmentLength;
+        int last = qMin(first + segmentLength, frames.count()) - 1;
+        bool changed = all || last >= previous.frames.count();
+        //a segment of the previous encoding may have been shorter, if it was the last one
+        if (!changed && segment == previous.segmentCount() - 1 && last != previous.frames.count() - 1) changed = true;
+        for (int i = first ; i <= last && !changed ; i++)
+        {
+            //a frame which can't be read is never considered unchanged
+            if (frames.at(i).size < 0 || frames.at(i) != previous.frames.at(i)) changed = true;
+        }
+        if (changed) segments << segment;
+    }
+
+    return segments;
+}
@@ -0,0 +1,77 @@
+#ifndef FFFRAMEMANIFEST_H
+#define FFFRAMEMANIFEST_H
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QStringList>
+
+#include "ffsequencescanner.h"
+
+/**
+ * @brief The FFFrame struct The state of a frame file when it was encoded
+ */
+struct FFFrame
+{
+    QString path;
+    qint64 size = -1;
+    /**
+     * @brief modified The date of the last modification, in ms since epoch
+     */
+    qint64 modified = 0;
+
+    bool operator==(const FFFrame &other) const;
+    bool operator!=(const FFFrame &other) const;
+};
+
+/**
+ * @brief The FFFrameManifest struct Lists the frames encoded to an output, and how they were encoded.
+ * It is saved next to a segmented output: when the output is encoded again,
+ * only the segments containing frames which have changed since the manifest was saved have to be encoded.
+ */
+struct FFFrameManifest
+{
+    /**
+     * @brief signature The FFmpeg arguments of the encoding, all the segments are encoded again if they change
+     */
+    QString signature;
+    /**
+     * @brief segmentLength The number of frames in each segment
+     */
+    int segmentLength = 0;
+    QList<FFFrame> frames;
+
+    /**
+     * @brief scan Reads the size and modification date of the frames, in parallel.
+     * It waits for all the frames to be read: don't call it from the UI thread
+     * @param files The frames, in order
+     */
+    static FFFrameManifest scan(const QStringList &files, QString signature, int segmentLength);
+    /**
+     * @brief load Reads a manifest saved by save()
+     * @return An empty manifest if the file can't be read
+     */
+    static FFFrameManifest load(QString fileName);
+    bool save(QString fileName) const;
+    /**
+     * @brief segmentCount The number of segments of the output
+     */
+    int segmentCount() const;
+    /**
+     * @brief changedSegments Compares with the manifest of the previous encoding
+     * @param previous The previous manifest
+     * @return The indices of the segments which must be encoded again
+     */
+    QList<int> changedSegments(const FFFrameManifest &previous) const;
+    /**
+     * @brief key Identifies the frames and the signature, it changes if any frame changes
+     * @return A hexadecimal SHA-1 hash
+     */
+    QString key() const;
+};
+
+#endif // FFFRAMEMANIFEST_H
@@ -0,0 +1,338 @@
+#include "ffimageheader.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFImageHeader::FFImageHeader(QObject *parent) : FFObject(parent)
+{
+
+}
+
+FFImageInfo FFImageHeader::read(QString fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return FFImageInfo();
+
+    QString extension = QFileInfo(fileName).suffix().toLower();
+    FFImageInfo info;
+    if (extension == "png") info = readPng(file);
+    else if (extension == "tga") info = readTga(file);
+    else if (extension == "jpg" || extension == "jpeg") info = readJpeg(file);
+    else if (extension == "dpx") info = readDpx(file);
+    else if (extension == "tif" || extension == "tiff") info = readTiff(file);
+
+    file.close();
+
+#ifdef QT_DEBUG
+    if (!info.valid) qDebug() << "Cannot read the image header" << fileName;
+#endif
+
+    return info;
+}
+
+bool FFImageHeader::isSupported(QString extension)
+{
+    extension = extension.toLower();
+    return extension == "png" || extension == "tga" || extension == "jpg" || extension == "jpeg" || extension == "dpx" || extension == "tif" || extension == "tiff";
+}
+
+FFImageInfo FFImageHeader::readPng(QFile &file)
+{
+    FFImageInfo info;
+    //signature (8) + IHDR length, type (8) + IHDR data (13)
+    QByteArray data = file.read(29);
+    if (data.count() < 29) return info;
+    if (!data.startsWith("\x89PNG\r\n\x1a\n") || data.mid(12,4) != "IHDR") return info;
+
+    info.format = "png";
+    info.width = number(data,16,4,true);
+    info.height = number(data,20,4,true);
+    info.bitDepth = number(data,24,1,true);
+    int colorType = number(data,25,1,true);
+
+    bool deep = info.bitDepth == 16;
+    if (colorType == 0)
+    {
+        info.channels = 1;
+        info.pixelFormat = deep ? "gray16be" : "gray";
+    }
+    else if (colorType == 2)
+    {
+        info.channels = 3;
+        info.pixelFormat = deep ? "rgb48be" : "rgb24";
+    }
+    else if (colorType == 3)
+    {
+        //palette: 8 bits per channel once decoded
+        info.channels = 3;
+        info.bitDepth = 8;
+        info.pixelFormat = "pal8";
+    }
+    else if (colorType == 4)
+    {
+        info.channels = 2;
+        info.alpha = true;
+        info.pixelFormat = deep ? "ya16be" : "ya8";
+    }
+    else if (colorType == 6)
+    {
+        info.channels = 4;
+        info.alpha = true;
+        info.pixelFormat = deep ? "rgba64be" : "rgba";
+    }
+    else return info;
+
+    info.valid = info.width > 0 && info.height > 0;
+    return info;
+}
+
+FFImageInfo FFImageHeader::readTga(QFile &file)
+{
+    FFImageInfo info;
+    QByteArray data = file.read(18);
+    if (data.count() < 18) return info;
+
+    //there is no signature, check that the values make sense
+    int colorMapType = number(data,1,1,false);
+    int imageType = number(data,2,1,false);
+    int pixelDepth = number(data,16,1,false);
+    int alphaBits = number(data,17,1,false) & 0x0F;
+    if (colorMapType > 1) return info;
+    if (imageType != 1 && imageType != 2 && imageType != 3 && imageType != 9 && imageType != 10 && imageType != 11) return info;
+
+    info.format = "tga";
+    info.width = number(data,12,2,false);
+    info.height = number(data,14,2,false);
+
+    //color mapped
+    if (imageType == 1 || imageType == 9)
+    {
+        info.channels = 3;
+        info.bitDepth = 8;
+        info.pixelFormat = "pal8";
+    }
+    //grayscale
+    else if (imageType == 3 || imageType == 11)
+    {
+        info.channels = 1;
+        info.bitDepth = pixelDepth;
+        info.pixelFormat = pixelDepth == 8 ? "gray" : "";
+    }
+    else if (pixelDepth == 15 || pixelDepth == 16)
+    {
+        info.channels = 3;
+        info.bitDepth = 5;
+        info.alpha = alphaBits > 0;
+        info.pixelFormat = "rgb555le";
+    }
+    else if (pixelDepth == 24)
+    {
+        info.channels = 3;
+        info.bitDepth = 8;
+        info.pixelFormat = "bgr24";
+    }
+    else if (pixelDepth == 32)
+    {
+        info.channels = 4;
+        info.bitDepth = 8;
+        info.alpha = true;
+        info.pixelFormat = "bgra";
+    }
+    else return info;
+
+    info.valid = info.width > 0 && info.height > 0;
+    return info;
+}
+
+FFImageInfo FFImageHeader::readJpeg(QFile &file)
+{
+    FFImageInfo info;
+    QByteArray data = file.read(2);
+    if (data != "\xFF\xD8") return info;
+
+    //jump from segment to segment until the start of frame; the metadata (EXIF, ICC...) is skipped, not read
+    while (!file.atEnd())
+    {
+        data = file.read(4);
+        if (data.count() < 4) return info;
+        if (quint8(data.at(0)) != 0xFF) return info;
+        int marker = number(data,1,1,true);
+        //fill bytes
+        if (marker == 0xFF)
+        {
+            file.seek(file.pos() - 3);
+            continue;
+        }
+        int length = number(data,2,2,true);
+        if (length < 2) return info;
+
+        //start of frame markers, except DHT (C4), JPG (C8) and DAC (CC)
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+        {
+            data = file.read(length - 2);
+            if (data.count() < 6) return info;
+            info.format = "jpeg";
+            info.bitDepth = number(data,0,1,true);
+            info.height = number(data,1,2,true);
+            info.width = number(data,3,2,true);
+            info.channels = number(data,5,1,true);
+            if (data.count() < 6 + info.channels * 3) return info;
+
+            if (info.channels == 1) info.pixelFormat = "gray";
+            else if (info.channels == 3 && info.bitDepth == 8)
+            {
+                //the chroma subsampling, from the sampling factors of the luma and the first chroma component
+                int luma = number(data,7,1,true);
+                int chroma = number(data,10,1,true);
+                int hRatio = (luma >> 4) / qMax(1, chroma >> 4);
+                int vRatio = (luma & 0x0F) / qMax(1, chroma & 0x0F);
+                if (hRatio == 2 && vRatio == 2) info.pixelFormat = "yuvj420p";
+                else if (hRatio == 2 && vRatio == 1) info.pixelFormat = "yuvj422p";
+                else if (hRatio == 1 && vRatio == 1) info.pixelFormat = "yuvj444p";
+            }
+
+            info.valid = info.width > 0 && info.height > 0;
+            return info;
+        }
+
+        //start of scan: no frame header before the data
+        if (marker == 0xDA) return info;
+        if (!file.seek(file.pos() + length - 2)) return info;
+    }
+    return info;
+}
+
+FFImageInfo FFImageHeader::readDpx(QFile &file)
+{
+    FFImageInfo info;
+    //file header (768) + image header up to the bit size of the first element
+    QByteArray data = file.read(804);
+    if (data.count() < 804) return info;
+
+    bool bigEndian;
+    if (data.startsWith("SDPX")) bigEndian = true;
+    else if (data.startsWith("XPDS")) bigEndian = false;
+    else return info;
+
+    info.format = "dpx";
+    info.width = number(data,772,4,bigEndian);
+    info.height = number(data,776,4,bigEndian);
+    int descriptor = number(data,800,1,bigEndian);
+    info.bitDepth = number(data,803,1,bigEndian);
+
+    //luma
+    if (descriptor == 6) info.channels = 1;
+    //RGB
+    else if (descriptor == 50) info.channels = 3;
+    //RGBA, ABGR
+    else if (descriptor == 51 || descriptor == 52)
+    {
+        info.channels = 4;
+        info.alpha = true;
+    }
+    else return info;
+
+    QString endianness = bigEndian ? "be" : "le";
+    if (info.channels == 1)
+    {
+        if (info.bitDepth == 8) info.pixelFormat = "gray";
+        else if (info.bitDepth == 10 || info.bitDepth == 12 || info.bitDepth == 16) info.pixelFormat = "gray" + QString::number(info.bitDepth) + endianness;
+    }
+    else if (info.bitDepth == 8) info.pixelFormat = info.alpha ? "rgba" : "rgb24";
+    else if (info.bitDepth == 10 || info.bitDepth == 12) info.pixelFormat = (info.alpha ? "gbrap" : "gbrp") + QString::number(info.bitDepth) + endianness;
+    else if (info.bitDepth == 16) info.pixelFormat = (info.alpha ? "rgba64" : "rgb48") + endianness;
+
+    info.valid = info.width > 0 && info.height > 0;
+    return info;
+}
+
+FFImageInfo FFImageHeader::readTiff(QFile &file)
+{
+    FFImageInfo info;
+    QByteArray data = file.read(8);
+    if (data.count() < 8) return info;
+
+    bool bigEndian;
+    if (data.startsWith(QByteArray("MM\x00\x2A",4))) bigEndian = true;
+    else if (data.startsWith(QByteArray("II\x2A\x00",4))) bigEndian = false;
+    else return info;
+
+    //first image file directory
+    quint32 offset = number(data,4,4,bigEndian);
+    if (!file.seek(offset)) return info;
+    data = file.read(2);
+    if (data.count() < 2) return info;
+    int entries = number(data,0,2,bigEndian);
+    data = file.read(entries * 12);
+    if (data.count() < entries * 12) return info;
+
+    info.format = "tiff";
+    info.channels = 1;
+    info.bitDepth = 1;
+    int photometric = -1;
+    int extraSamples = 0;
+    for (int i = 0 ; i < entries ; i++)
+    {
+        int pos = i * 12;
+        int tag = number(data,pos,2,bigEndian);
+        int type = number(data,pos+2,2,bigEndian);
+        //the values which fit are stored in the entry, left-justified; only the first one is needed here
+        quint32 value;
+        if (type == 3) value = number(data,pos+8,2,bigEndian);
+        else if (type == 1) value = number(data,pos+8,1,bigEndian);
+        else value = number(data,pos+8,4,bigEndian);
+
+        if (tag == 256) info.width = value;
+        else if (tag == 257) info.height = value;
+        else if (tag == 258)
+        {
+            //several samples which do not fit in the entry: the value is an offset
+            quint32 count = number(data,pos+4,4,bigEndian);
+            if (count > 2 && type == 3)
+            {
+                qint64 current = file.pos();
+                if (file.seek(value))
+                {
+                    QByteArray bits = file.read(2);
+                    if (bits.count() == 2) value = number(bits,0,2,bigEndian);
+                }
+                file.seek(current);
+            }
+            info.bitDepth = value;
+        }
+        else if (tag == 262) photometric = value;
+        else if (tag == 277) info.channels = value;
+        else if (tag == 338) extraSamples = number(data,pos+4,4,bigEndian);
+    }
+
+    //RGB + extra or gray + extra
+    info.alpha = extraSamples > 0 || info.channels == 4 || (info.channels == 2 && photometric <= 1);
+
+    QString endianness = bigEndian ? "be" : "le";
+    if (photometric == 3) info.pixelFormat = "pal8";
+    else if (photometric <= 1 && info.channels == 1)
+    {
+        if (info.bitDepth == 8) info.pixelFormat = "gray";
+        else if (info.bitDepth == 16) info.pixelFormat = "gray16" + endianness;
+    }
+    else if (photometric == 2 && info.channels >= 3)
+    {
+        if (info.bitDepth == 8) info.pixelFormat = info.alpha ? "rgba" : "rgb24";
+        else if (info.bitDepth == 16) info.pixelFormat = (info.alpha ? "rgba64" : "rgb48") + endianness;
+    }
+
+    info.valid = info.width > 0 && info.height > 0;
+    return info;
+}
+
+quint32 FFImageHeader::number(const QByteArray &data, int pos, int bytes, bool bigEndian)
+{
+    quint32 value = 0;
+    for (int i = 0 ; i < bytes ; i++)
+    {
+        int index = bigEndian ? pos + i : pos + bytes - 1 - i;
+        value = (value << 8) | quint8(data.at(index));
+    }
+    return value;
+}
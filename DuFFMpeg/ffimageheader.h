@@ -0,0 +1,70 @@
+#ifndef FFIMAGEHEADER_H
+#define FFIMAGEHEADER_H
+
+#include "ffobject.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+/**
+ * @brief The FFImageInfo struct What the header of an image file tells
+ */
+struct FFImageInfo
+{
+    bool valid = false;
+    /**
+     * @brief format png, tga, jpeg, dpx or tiff
+     */
+    QString format;
+    int width = 0;
+    int height = 0;
+    /**
+     * @brief bitDepth The number of bits per channel
+     */
+    int bitDepth = 0;
+    int channels = 0;
+    bool alpha = false;
+    /**
+     * @brief pixelFormat The name FFmpeg gives to the pixel format, empty if unknown
+     */
+    QString pixelFormat;
+};
+
+/**
+ * @brief The FFImageHeader class Reads the header of PNG, TGA, JPEG, DPX and TIFF files without running FFmpeg.
+ * Only the first bytes of the files are read (and the segment headers for JPEG, the first directory for TIFF).
+ */
+class FFImageHeader : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFImageHeader(QObject *parent = nullptr);
+
+    /**
+     * @brief read Reads the header of an image
+     * @param fileName The file
+     * @return The info, not valid if the format is not supported or the header is corrupted
+     */
+    static FFImageInfo read(QString fileName);
+    /**
+     * @brief isSupported Checks if the header of the files with this extension can be read
+     */
+    static bool isSupported(QString extension);
+
+private:
+    static FFImageInfo readPng(QFile &file);
+    static FFImageInfo readTga(QFile &file);
+    static FFImageInfo readJpeg(QFile &file);
+    static FFImageInfo readDpx(QFile &file);
+    static FFImageInfo readTiff(QFile &file);
+    /**
+     * @brief number Reads an unsigned integer in a buffer
+     * @param data The buffer, which must be long enough
+     * @param pos The position of the first byte
+     * @param bytes The size of the integer, 1, 2 or 4
+     * @param bigEndian The byte order
+     */
+    static quint32 number(const QByteArray &data, int pos, int bytes, bool bigEndian);
+};
+
+#endif // FFIMAGEHEADER_H
@@ -0,0 +1,93 @@
+#include "fflogwriter.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFLogWriter::FFLogWriter(QObject *parent) : FFObject(parent)
+{
+    _maxFileSize = 10*1024*1024;
+    _maxFiles = 5;
+}
+
+FFLogWriter::~FFLogWriter()
+{
+    foreach(QFile *file,_files)
+    {
+        file->close();
+        delete file;
+    }
+}
+
+void FFLogWriter::write(QString fileName, QString text)
+{
+    QFile *file = _files.value(fileName,nullptr);
+    if (file == nullptr)
+    {
+        QDir().mkpath(QFileInfo(fileName).path());
+        file = new QFile(fileName);
+        if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
+        {
+#ifdef QT_DEBUG
+            qDebug() << "Cannot write the log file" << fileName;
+#endif
+            delete file;
+            return;
+        }
+        _files.insert(fileName,file);
+    }
+
+    file->write(text.toUtf8());
+    //the logs must be complete if the application crashes
+    file->flush();
+
+    if (_maxFileSize > 0 && file->size() > _maxFileSize) rotate(file);
+}
+
+void FFLogWriter::close(QString fileName)
+{
+    QFile *file = _files.take(fileName);
+    if (file == nullptr) return;
+    file->close();
+    delete file;
+}
+
+void FFLogWriter::setMaxFileSize(qint64 size)
+{
+    _maxFileSize = size;
+}
+
+void FFLogWriter::setMaxFiles(int count)
+{
+    if (count < 1) count = 1;
+    _maxFiles = count;
+}
+
+void FFLogWriter::rotate(QFile *file)
+{
+    QString fileName = file->fileName();
+    file->close();
+
+    //shift the previous ones, the oldest is removed
+    QFile::remove(rotatedFileName(fileName,_maxFiles));
+    for (int i = _maxFiles - 1 ; i > 0 ; i--)
+    {
+        QFile::rename(rotatedFileName(fileName,i),rotatedFileName(fileName,i+1));
+    }
+    QFile::rename(fileName,rotatedFileName(fileName,1));
+
+    file->setFileName(fileName);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        _files.remove(fileName);
+        delete file;
+    }
+}
+
+QString FFLogWriter::rotatedFileName(QString fileName, int index)
+{
+    QFileInfo info(fileName);
+    QString name = info.path() + "/" + info.completeBaseName() + "." + QString::number(index);
+    if (info.suffix() != "") name += "." + info.suffix();
+    return name;
+}
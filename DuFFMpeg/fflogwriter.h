@@ -0,0 +1,62 @@
+#ifndef FFLOGWRITER_H
+#define FFLOGWRITER_H
+
+#include "ffobject.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMap>
+
+/**
+ * @brief The FFLogWriter class Writes the log files.
+ * It lives in its own thread: the other objects call its slots through queued connections and never wait for the disk.
+ * When a file exceeds the maximum size, it is rotated: file.log becomes file.1.log, file.1.log becomes file.2.log...
+ */
+class FFLogWriter : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFLogWriter(QObject *parent = nullptr);
+    ~FFLogWriter();
+
+public slots:
+    /**
+     * @brief write Appends text to a file, which is opened if needed
+     * @param fileName The path of the file
+     * @param text The text
+     */
+    void write(QString fileName, QString text);
+    /**
+     * @brief close Closes a file which will not be written anymore
+     * @param fileName The path of the file
+     */
+    void close(QString fileName);
+    /**
+     * @brief setMaxFileSize Sets the size at which the files are rotated
+     * @param size The size in bytes, 0 to never rotate
+     */
+    void setMaxFileSize(qint64 size);
+    /**
+     * @brief setMaxFiles Sets the number of rotated files kept for each log
+     * @param count The number of files, the older ones are removed
+     */
+    void setMaxFiles(int count);
+
+private:
+    QMap<QString, QFile *> _files;
+    qint64 _maxFileSize;
+    int _maxFiles;
+    /**
+     * @brief rotate Renames the file and the previous rotated files, and opens a new one
+     */
+    void rotate(QFile *file);
+    /**
+     * @brief rotatedFileName The name of a rotated file
+     * @param fileName The name of the log
+     * @param index The index of the rotation
+     */
+    QString rotatedFileName(QString fileName, int index);
+};
+
+#endif // FFLOGWRITER_H
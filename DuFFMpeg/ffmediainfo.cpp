@@ -30,22 +30,37 @@ void FFMediaInfo::updateInfo(QString ffmpegOutput)
     _loop = -1;
     _videoProfile = -1;
     _startNumber = 0;
+    _pixelFormat = "";
+    _bitDepth = 0;
+    _alpha = false;
+    _frameNumbers.clear();
+    _missingFrames.clear();
+    _duplicateFrames.clear();
+    _holdMissingFrames = false;
+    _followSequence = false;
+    _segmentLength = 0;
+    _mezzanineKey = "";
+    _compressionLevel = -1;
+    _prediction = "";
+    _compressionMethod = "";
 
     QStringList infos = ffmpegOutput.split("\n");
 
     //regexes to get infos
-    QRegularExpression reInput("Input #\\d+, ([\\w+,]+) from '(.+)':");
-    QRegularExpression reVideoStream("Stream #.+Video: .+, (\\d+)x(\\d+).+, (\\d{1,3}(?:\\.\\d{0,3})?) fps");
-    QRegularExpression reSequenceStream("Stream #.+Video: .+, (\\d+)x(\\d+)");
-    QRegularExpression reAudioStream("Stream #.+Audio: .+, (\\d{4,6}) Hz");
-    QRegularExpression reDuration("Duration: (?:(\\d\\d):(\\d\\d):(\\d\\d.\\d\\d), )?(?:(N\\/A), )?");
+    const QRegularExpression &reInput = FFOutputParser::regExp(FFOutputParser::Input);
+    const QRegularExpression &reVideoStream = FFOutputParser::regExp(FFOutputParser::VideoStream);
+    const QRegularExpression &reSequenceStream = FFOutputParser::regExp(FFOutputParser::SequenceStream);
+    const QRegularExpression &rePixelFormat = FFOutputParser::regExp(FFOutputParser::PixelFormat);
+    const QRegularExpression &reAudioStream = FFOutputParser::regExp(FFOutputParser::AudioStream);
+    const QRegularExpression &reDuration = FFOutputParser::regExp(FFOutputParser::Duration);
 
 
     bool input = false;
     foreach(QString info,infos)
     {
         //test input
-        QRegularExpressionMatch match = reInput.match(info);
+        QRegularExpressionMatch match;
+        if (info.startsWith("Input #")) match = reInput.match(info);
         if (match.hasMatch())
         {
             input = true;
@@ -57,7 +72,8 @@ void FFMediaInfo::updateInfo(QString ffmpegOutput)
         if (!input) continue;
 
         //test duration
-        match = reDuration.match(info);
+        match = QRegularExpressionMatch();
+        if (info.contains("Duration: ")) match = reDuration.match(info);
         if (match.hasMatch())
         {
             qDebug() << info;
@@ -77,6 +93,9 @@ void FFMediaInfo::updateInfo(QString ffmpegOutput)
             }
         }
 
+        //only streams are left, no need to run the regexes on the other lines
+        if (!info.contains("Stream #")) continue;
+
         //test video stream
         match = reVideoStream.match(info);
         if (match.hasMatch())
@@ -88,6 +107,9 @@ void FFMediaInfo::updateInfo(QString ffmpegOutput)
             _videoFramerate = match.captured(3).toDouble();
             if (_videoFramerate == 0) _videoFramerate = 24;
             _video = true;
+            //pixel format
+            match = rePixelFormat.match(info);
+            if (match.hasMatch()) _pixelFormat = match.captured(1);
             continue;
         }
 
@@ -101,6 +123,9 @@ void FFMediaInfo::updateInfo(QString ffmpegOutput)
             _videoHeight = match.captured(2).toInt();
             _videoFramerate = 24;
             _video = true;
+            //pixel format
+            match = rePixelFormat.match(info);
+            if (match.hasMatch()) _pixelFormat = match.captured(1);
             continue;
         }
 
@@ -116,7 +141,44 @@ void FFMediaInfo::updateInfo(QString ffmpegOutput)
         }
     }
 
-    if (_imageSequence) loadSequence();
+    if (_imageSequence)
+    {
+        qint64 traceStart = FFTrace::now();
+        loadSequence();
+        QJsonObject traceArgs;
+        traceArgs.insert("path",_fileName);
+        traceArgs.insert("frames",_frames.count());
+        FFTrace::span("discovery","probe",0,traceStart,traceArgs);
+    }
+}
+
+bool FFMediaInfo::loadImageSequence(QString fileName)
+{
+    if (!FFImageHeader::isSupported(QFileInfo(fileName).suffix())) return false;
+
+    qint64 traceStart = FFTrace::now();
+    FFImageInfo image = FFImageHeader::read(fileName);
+    if (!image.valid) return false;
+
+    updateInfo("");
+    _fileName = fileName;
+    _extensions << "image2";
+    _imageSequence = true;
+    _video = true;
+    _videoFramerate = 24;
+    _videoWidth = image.width;
+    _videoHeight = image.height;
+    _pixelFormat = image.pixelFormat;
+    _bitDepth = image.bitDepth;
+    _alpha = image.alpha;
+
+    loadSequence();
+    QJsonObject traceArgs;
+    traceArgs.insert("path",_fileName);
+    traceArgs.insert("frames",_frames.count());
+    traceArgs.insert("format",image.format);
+    FFTrace::span("discovery","probe",0,traceStart,traceArgs);
+    return true;
 }
 
 void FFMediaInfo::setVideoWidth(int width)
@@ -285,12 +347,18 @@ double FFMediaInfo::videoBitrate(BitrateUnit unit)
 
 double FFMediaInfo::size(FFMediaInfo::SizeUnit unit)
 {
+    if (_size < 0) _size = FFSequenceScanner::totalSize(_frames);
     double s = _size;
     if (unit == KB) s = s/1024;
     if (unit == MB) s = s/1024/1024;
     return s;
 }
 
+bool FFMediaInfo::hasSize() const
+{
+    return _size >= 0;
+}
+
 QList<QStringList> FFMediaInfo::ffmpegOptions()
 {
     return _ffmpegOptions;
@@ -380,6 +448,14 @@ QString FFMediaInfo::exportToJson()
         videoObj.insert("profile",_videoProfile);
         //start number
         videoObj.insert("startNumber",_startNumber);
+        //segments
+        videoObj.insert("segmentLength",_segmentLength);
+        //image compression
+        videoObj.insert("compressionLevel",_compressionLevel);
+        videoObj.insert("prediction",_prediction);
+        videoObj.insert("compressionMethod",_compressionMethod);
+        //pixel format
+        videoObj.insert("pixelFormat",_pixelFormat);
 
         mediaObj.insert("video",videoObj);
     }
@@ -450,118 +526,185 @@ void FFMediaInfo::setFrames(const QStringList &frames)
 void FFMediaInfo::loadSequence()
 {
     _frames.clear();
+    _frameNumbers.clear();
+    _missingFrames.clear();
+    _duplicateFrames.clear();
     _startNumber = 0;
 
     if (_fileName == "") return;
 
-    //base file info
-    QFileInfo baseFileInfo(_fileName);
-    QString extension = baseFileInfo.suffix();
-    QString baseName = baseFileInfo.completeBaseName();
-    QString dirPath = baseFileInfo.path();
+    FFSequence sequence = FFSequenceScanner::sequence(_fileName);
+    //if we didn't find any digit in the name, nothing to do
+    if (sequence.frames.count() == 0) return;
+
+    _frames = sequence.frames;
+    _frameNumbers = sequence.numbers;
+    _startNumber = sequence.startNumber;
+    //FFmpeg stops at the first gap
+    _missingFrames = sequence.missingNumbers();
+    _duplicateFrames = sequence.duplicateNumbers();
+    //the size of the files is read only if it's needed
+    _size = -1;
+    //update filename with ffmpeg convention
+    _fileName = sequence.fileName();
+}
 
+int FFMediaInfo::bitDepth() const
+{
+    return _bitDepth;
+}
 
-    //find digits in the name
-    QRegularExpression reDigits("(\\d+)");
-    QRegularExpressionMatchIterator reDigitsMatch = reDigits.globalMatch(baseName);
+void FFMediaInfo::setBitDepth(int bitDepth)
+{
+    _bitDepth = bitDepth;
+}
 
-    //if we didn't find any digit in the name, nothing to do
-    if (!reDigitsMatch.hasNext()) return;
+bool FFMediaInfo::hasAlpha() const
+{
+    return _alpha;
+}
+
+void FFMediaInfo::setAlpha(bool alpha)
+{
+    _alpha = alpha;
+}
+
+QList<int> FFMediaInfo::missingFrames() const
+{
+    return _missingFrames;
+}
+
+QList<int> FFMediaInfo::duplicateFrames() const
+{
+    return _duplicateFrames;
+}
+
+bool FFMediaInfo::holdMissingFrames() const
+{
+    return _holdMissingFrames;
+}
+
+void FFMediaInfo::setHoldMissingFrames(bool hold)
+{
+    _holdMissingFrames = hold;
+}
+
+bool FFMediaInfo::followSequence() const
+{
+    return _followSequence;
+}
+
+void FFMediaInfo::setFollowSequence(bool follow)
+{
+    _followSequence = follow;
+}
+
+int FFMediaInfo::segmentLength() const
+{
+    return _segmentLength;
+}
+
+void FFMediaInfo::setSegmentLength(int length)
+{
+    _segmentLength = length;
+}
+
+QString FFMediaInfo::mezzanineKey() const
+{
+    return _mezzanineKey;
+}
 
-    //get all files of same type in folder
-    QDir containingDir(dirPath);
-    QFileInfoList files = containingDir.entryInfoList(QStringList("*." + extension),QDir::Files);
+void FFMediaInfo::setMezzanineKey(const QString &key)
+{
+    _mezzanineKey = key;
+}
+
+int FFMediaInfo::compressionLevel() const
+{
+    return _compressionLevel;
+}
+
+void FFMediaInfo::setCompressionLevel(int level)
+{
+    _compressionLevel = level;
+}
+
+QString FFMediaInfo::prediction() const
+{
+    return _prediction;
+}
+
+void FFMediaInfo::setPrediction(const QString &prediction)
+{
+    _prediction = prediction;
+}
+
+QString FFMediaInfo::compressionMethod() const
+{
+    return _compressionMethod;
+}
+
+void FFMediaInfo::setCompressionMethod(const QString &method)
+{
+    _compressionMethod = method;
+}
 
-    //find where is the base file
-    int baseIndex = 0;
-    for (int i = 0 ; i < files.count() ; i++)
+QStringList FFMediaInfo::frameList()
+{
+    if (_frames.count() != _frameNumbers.count()) return _frames;
+
+    QStringList list;
+    QString previousFrame = "";
+    int previousNumber = 0;
+    for (int i = 0 ; i < _frames.count() ; i++)
     {
-        QFileInfo file = files[i];
-        if (file.completeBaseName() == baseName)
+        int number = _frameNumbers.at(i);
+        if (i > 0)
         {
-            baseIndex = i;
-            break;
+            //duplicates: the first file is kept
+            if (number == previousNumber) continue;
+            //the previous frame is held during the gap
+            if (_holdMissingFrames) for (int n = previousNumber + 1 ; n < number ; n++) list << previousFrame;
         }
+        previousFrame = _frames.at(i);
+        previousNumber = number;
+        list << previousFrame;
     }
+    return list;
+}
 
-    //check for each block of digits the one where we have a next and previous file
-    while(reDigitsMatch.hasNext())
-    {
-        QRegularExpressionMatch match = reDigitsMatch.next();
-        QString digits = match.captured(0);
-        int num = digits.toInt();
-        bool ok = false;
-        //test next file
-        if (baseIndex < files.count()-1)
-        {
-            QString nextName = files[baseIndex+1].completeBaseName();
-            //check if num+1 is at the same place
-            int nextNum = num+1;
-            QString nextDigits = QString::number(nextNum);
-            while(nextDigits.count() < digits.count())
-            {
-                nextDigits = "0" + nextDigits;
-            }
-            if (nextName.indexOf(nextDigits) == match.capturedStart(0)) ok = true;
-        }
-        else
-        {
-            ok = true;
-        }
+QString FFMediaInfo::concatList()
+{
+    QString list = "ffconcat version 1.0\n";
+    QStringList frames = frameList();
+    if (frames.count() == 0) return list;
 
-        //test previous file
-        if (ok)
-        {
-            ok = false;
-            if (baseIndex > 0)
-            {
-                QString prevName = files[baseIndex-1].completeBaseName();
-                //check if num-1 is at the same place
-                int prevNum = num-1;
-                QString prevDigits = QString::number(prevNum);
-                while(prevDigits.count() < digits.count())
-                {
-                    prevDigits = "0" + prevDigits;
-                }
-                if (prevName.indexOf(prevDigits) == match.capturedStart(0)) ok = true;
-            }
-            else
-            {
-                ok = true;
-            }
-        }
+    double framerate = _videoFramerate;
+    if (framerate <= 0) framerate = 24;
+    QString duration = "duration " + QString::number(1.0 / framerate,'f',6) + "\n";
 
-        //if next and previous file are ok, we found the digits block
-        if (ok)
-        {
-            //list all files in the sequence matching the pattern, and compute size
-            QString left = baseName.left(match.capturedStart(0));
-            QString right = baseName.right(baseName.count() - match.capturedEnd(0));
-            QString pattern = left + "(\\d+)" + right;
-            QRegularExpression re(pattern);
-            _startNumber = 999999999;
-            foreach(QFileInfo f,files)
-            {
-                QRegularExpressionMatch reMatch = re.match(f.completeBaseName());
-                if (reMatch.hasMatch())
-                {
-                    //get start frame
-                    int currentNumber = reMatch.captured(1).toInt();
-                    if (currentNumber < _startNumber) _startNumber = currentNumber;
-                    _frames << f.filePath();
-                    _size += f.size();
-                }
-            }
-            if (_startNumber == 999999999) _startNumber = 0;
-            //update filename with ffmpeg convention
-            QString digitsBlock = "";
-            while(digitsBlock.count() < digits.count())
-            {
-                digitsBlock += "#";
-            }
-            _fileName = dirPath + "/" + left + "{" + digitsBlock + "}" + right + "." + extension;
-        }
+    foreach(QString frame,frames)
+    {
+        QString path = QDir::toNativeSeparators(frame);
+        path.replace("'","'\\''");
+        list += "file '" + path + "'\n" + duration;
     }
+    //the duration of the last entry is ignored, it is repeated to be shown for its duration too
+    QString path = QDir::toNativeSeparators(frames.last());
+    path.replace("'","'\\''");
+    list += "file '" + path + "'\n";
+
+    return list;
+}
+
+QString FFMediaInfo::pixelFormat() const
+{
+    return _pixelFormat;
+}
+
+void FFMediaInfo::setPixelFormat(const QString &pixelFormat)
+{
+    _pixelFormat = pixelFormat;
 }
 
 int FFMediaInfo::startNumber() const
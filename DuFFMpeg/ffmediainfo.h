@@ -13,6 +13,10 @@
 
 #include "ffcodec.h"
 #include "ffmuxer.h"
+#include "ffoutputparser.h"
+#include "fftrace.h"
+#include "ffsequencescanner.h"
+#include "ffimageheader.h"
 
 class FFMediaInfo : public FFObject
 {
@@ -35,6 +39,12 @@ public:
     //setters
     void setMuxer(FFMuxer *muxer);
     void updateInfo(QString ffmpegOutput);
+    /**
+     * @brief loadImageSequence Loads the info of an image sequence from the header of one of its frames, without running FFmpeg
+     * @param fileName One of the frames
+     * @return false if the header can't be read, then the info has to be loaded from FFmpeg
+     */
+    bool loadImageSequence(QString fileName);
     void setContainer(QStringList container);
     void setVideoWidth(int width);
     void setVideoHeight(int height);
@@ -58,6 +68,16 @@ public:
     void clearFFmpegOptions();
     void setStartNumber(int startNumber);
     void setFrames(const QStringList &frames);
+    void setPixelFormat(const QString &pixelFormat);
+    void setBitDepth(int bitDepth);
+    void setAlpha(bool alpha);
+    void setHoldMissingFrames(bool hold);
+    void setFollowSequence(bool follow);
+    void setSegmentLength(int length);
+    void setMezzanineKey(const QString &key);
+    void setCompressionLevel(int level);
+    void setPrediction(const QString &prediction);
+    void setCompressionMethod(const QString &method);
     //getters
     FFMuxer *muxer() const;
     int videoWidth();
@@ -71,7 +91,15 @@ public:
     FFCodec *audioCodec();
     double audioBitrate(BitrateUnit unit = Bits);
     double videoBitrate(BitrateUnit unit = Bits);
+    /**
+     * @brief size The size of the media, or of all the frames of a sequence.
+     * The frames are read the first time it's called, which can be long on a network share: check hasSize() first from the UI
+     */
     double size(SizeUnit unit = Bytes);
+    /**
+     * @brief hasSize False while the size of the frames of a sequence has not been read
+     */
+    bool hasSize() const;
     QList<QStringList> ffmpegOptions();
     bool hasVideo();
     bool hasAudio();
@@ -82,6 +110,58 @@ public:
     int loop() const;
     int startNumber() const;
     QStringList frames() const;
+    QString pixelFormat() const;
+    /**
+     * @brief bitDepth The number of bits per channel, 0 if unknown
+     */
+    int bitDepth() const;
+    bool hasAlpha() const;
+    /**
+     * @brief missingFrames The numbers of the frames missing in the sequence
+     */
+    QList<int> missingFrames() const;
+    /**
+     * @brief duplicateFrames The numbers found in several files of the sequence, only the first file is used
+     */
+    QList<int> duplicateFrames() const;
+    /**
+     * @brief holdMissingFrames When true, a sparse sequence is encoded through a concat list where the previous frame replaces the missing ones
+     */
+    bool holdMissingFrames() const;
+    /**
+     * @brief frameList The frames to encode, in order: one file per frame number, and the previous frame in place of the missing ones if they are held
+     */
+    QStringList frameList();
+    /**
+     * @brief concatList The ffconcat script listing the frames of frameList()
+     */
+    QString concatList();
+    /**
+     * @brief followSequence When true, the sequence is still being rendered: its frames are sent to FFmpeg as they are written
+     */
+    bool followSequence() const;
+    /**
+     * @brief segmentLength When not 0, the output is encoded by segments of this number of frames,
+     * and only the segments containing changed frames are encoded again
+     */
+    int segmentLength() const;
+    /**
+     * @brief mezzanineKey Identifies the frames of the sequence and how they are read, in the mezzanine cache.
+     * It is computed when the sequence is encoded, reading the state of all the frames; empty until then
+     */
+    QString mezzanineKey() const;
+    /**
+     * @brief compressionLevel The zlib compression level of PNG images, from 0 (fastest) to 9 (smallest), -1 for the default
+     */
+    int compressionLevel() const;
+    /**
+     * @brief prediction The filter applied to PNG images before compression (none, sub, up, avg, paeth, mixed), empty for the default
+     */
+    QString prediction() const;
+    /**
+     * @brief compressionMethod The compression of TIFF images (raw, packbits, lzw, deflate), empty for the default
+     */
+    QString compressionMethod() const;
 
     //utils
     QString exportToJson();
@@ -96,7 +176,10 @@ private:
     QStringList _extensions;
     FFMuxer *_muxer;
     double _duration;
-    int _size;
+    /**
+     * @brief _size The size in bytes, -1 if the size of the frames has not been read yet
+     */
+    qint64 _size;
     bool _video;
     bool _audio;
     bool _imageSequence;
@@ -116,6 +199,19 @@ private:
     int _videoProfile;
     int _loop;
     int _startNumber;
+    QString _pixelFormat;
+    int _bitDepth;
+    bool _alpha;
+    QList<int> _frameNumbers;
+    QList<int> _missingFrames;
+    QList<int> _duplicateFrames;
+    bool _holdMissingFrames;
+    bool _followSequence;
+    int _segmentLength;
+    QString _mezzanineKey;
+    int _compressionLevel;
+    QString _prediction;
+    QString _compressionMethod;
 
     void loadSequence();
 
@@ -0,0 +1,200 @@
+#include "ffmemoryestimator.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFMemoryEstimator::FFMemoryEstimator(QObject *parent) : FFObject(parent)
+{
+
+}
+
+qint64 FFMemoryEstimator::estimate(FFQueueItem *item)
+{
+    double correction = _corrections.value(modelKey(item),1.0);
+    return modelEstimate(item) * correction;
+}
+
+void FFMemoryEstimator::addSample(FFQueueItem *item, qint64 peakMemory)
+{
+    if (peakMemory <= 0) return;
+    qint64 modeled = modelEstimate(item);
+    if (modeled <= 0) return;
+
+    //ratio between what has been measured and what the model says
+    double ratio = double(peakMemory) / double(modeled);
+    ratio = qBound(0.25,ratio,8.0);
+
+    //smooth with the previous samples
+    QString key = modelKey(item);
+    if (_corrections.contains(key)) ratio = _corrections.value(key)*0.5 + ratio*0.5;
+    _corrections.insert(key,ratio);
+
+#ifdef QT_DEBUG
+    qDebug() << "Memory model correction for" << key << ratio;
+#endif
+}
+
+qint64 FFMemoryEstimator::totalMemory()
+{
+#ifdef Q_OS_LINUX
+    //the value is in kB
+    qint64 total = FFProcessMonitor::procValue(FFProcessMonitor::readProcFile("/proc/meminfo"),"MemTotal:");
+    if (total <= 0) return -1;
+    return total * 1024;
+#else
+    return -1;
+#endif
+}
+
+qint64 FFMemoryEstimator::modelEstimate(FFQueueItem *item)
+{
+    //base memory of an FFmpeg process (binary, libraries, demuxers and muxers)
+    double memory = 48*1024*1024;
+
+    int defaultThreads = QThread::idealThreadCount();
+    if (defaultThreads < 1) defaultThreads = 1;
+
+    int inputWidth = 0;
+    int inputHeight = 0;
+    QString inputPixelFormat = "";
+
+    //decoders
+    foreach(FFMediaInfo *input,item->getInputMedias())
+    {
+        if (!input->hasVideo()) continue;
+
+        int threads = option(input,"-threads").toInt();
+        if (threads <= 0) threads = defaultThreads;
+
+        double frameSize = double(input->videoWidth()) * input->videoHeight() * bytesPerPixel(input->pixelFormat());
+        //frame threads + reference frames
+        memory += frameSize * (threads + 4);
+
+        if (inputWidth == 0)
+        {
+            inputWidth = input->videoWidth();
+            inputHeight = input->videoHeight();
+            inputPixelFormat = input->pixelFormat();
+        }
+    }
+
+    //encoders
+    foreach(FFMediaInfo *output,item->getOutputMedias())
+    {
+        if (!output->hasVideo()) continue;
+
+        QString codec = "";
+        if (output->videoCodec() != nullptr) codec = output->videoCodec()->name();
+        else if (output->muxer() != nullptr)
+        {
+            if (output->muxer()->defaultVideoCodec() != nullptr) codec = output->muxer()->defaultVideoCodec()->name();
+        }
+        if (codec == "copy") continue;
+
+        int width = output->videoWidth();
+        int height = output->videoHeight();
+        if (width == 0 || height == 0)
+        {
+            width = inputWidth;
+            height = inputHeight;
+        }
+
+        //the pixel format of the output settings, or set in the custom options
+        QString pixelFormat = output->pixelFormat();
+        if (pixelFormat == "") pixelFormat = option(output,"-pix_fmt");
+        if (pixelFormat == "") pixelFormat = defaultPixelFormat(codec,inputPixelFormat);
+
+        int threads = option(output,"-threads").toInt();
+        if (threads <= 0) threads = defaultThreads;
+
+        double frameSize = double(width) * height * bytesPerPixel(pixelFormat);
+        //one more frame for the scaler / pixel format conversion
+        memory += frameSize * (bufferedFrames(codec,threads) + 1);
+    }
+
+    return memory;
+}
+
+QString FFMemoryEstimator::modelKey(FFQueueItem *item)
+{
+    foreach(FFMediaInfo *output,item->getOutputMedias())
+    {
+        if (!output->hasVideo()) continue;
+        if (output->videoCodec() != nullptr) return output->videoCodec()->name();
+        if (output->muxer() != nullptr) return output->muxer()->name();
+    }
+    return "default";
+}
+
+double FFMemoryEstimator::bytesPerPixel(QString pixelFormat)
+{
+    pixelFormat = pixelFormat.toLower();
+
+    //unknown, assume 8 bit 4:4:4
+    if (pixelFormat == "") return 3;
+
+    //formats where the name gives the total depth
+    if (pixelFormat.startsWith("rgba64") || pixelFormat.startsWith("bgra64")) return 8;
+    if (pixelFormat.startsWith("rgb48") || pixelFormat.startsWith("bgr48")) return 6;
+
+    double bytes = 3;
+    if (pixelFormat.startsWith("yuva420")) bytes = 2.5;
+    else if (pixelFormat.startsWith("yuva422")) bytes = 3;
+    else if (pixelFormat.startsWith("yuva444")) bytes = 4;
+    else if (pixelFormat.startsWith("yuv420") || pixelFormat.startsWith("yuvj420") || pixelFormat.startsWith("yuv411") ||
+             pixelFormat.startsWith("nv12") || pixelFormat.startsWith("nv21") || pixelFormat.startsWith("p010") || pixelFormat.startsWith("p016")) bytes = 1.5;
+    else if (pixelFormat.startsWith("yuv422") || pixelFormat.startsWith("yuvj422") || pixelFormat.startsWith("nv16") ||
+             pixelFormat.startsWith("uyvy") || pixelFormat.startsWith("yuyv")) bytes = 2;
+    else if (pixelFormat.startsWith("yuv444") || pixelFormat.startsWith("yuvj444") || pixelFormat.startsWith("gbrp")) bytes = 3;
+    else if (pixelFormat.startsWith("gbrap")) bytes = 4;
+    else if (pixelFormat.startsWith("rgba") || pixelFormat.startsWith("bgra") || pixelFormat.startsWith("argb") || pixelFormat.startsWith("abgr") ||
+             pixelFormat.startsWith("rgb0") || pixelFormat.startsWith("bgr0") || pixelFormat.startsWith("0rgb") || pixelFormat.startsWith("0bgr")) bytes = 4;
+    else if (pixelFormat.startsWith("rgb24") || pixelFormat.startsWith("bgr24")) bytes = 3;
+    else if (pixelFormat.startsWith("ya")) bytes = 2;
+    else if (pixelFormat.startsWith("gray") || pixelFormat.startsWith("pal") || pixelFormat == "rgb8" || pixelFormat == "bgr8") bytes = 1;
+
+    //high bit depth formats use 16 bit per component
+    if (FFOutputParser::regExp(FFOutputParser::HighBitDepth).match(pixelFormat).hasMatch()) bytes = bytes*2;
+
+    return bytes;
+}
+
+int FFMemoryEstimator::bufferedFrames(QString codec, int threads)
+{
+    //long GOP encoders with lookahead, which also keep several planes for each frame
+    if (codec == "h264" || codec == "libx264" || codec == "libx264rgb" || codec == "hevc" || codec == "libx265")
+    {
+        return (40 + threads) * 3;
+    }
+    if (codec == "libvpx" || codec == "libvpx-vp9" || codec == "vp8" || codec == "vp9" || codec == "libaom-av1")
+    {
+        return (25 + threads) * 2;
+    }
+    //intra-frame encoders: one frame in and one packet out for each thread
+    return threads * 2 + 4;
+}
+
+QString FFMemoryEstimator::defaultPixelFormat(QString codec, QString inputPixelFormat)
+{
+    if (codec.startsWith("prores") || codec == "dnxhd") return "yuv422p10le";
+    if (codec == "hap") return "rgba";
+    if (codec == "gif") return "pal8";
+    if (codec == "png" || codec == "targa" || codec == "tiff" || codec == "dpx")
+    {
+        if (inputPixelFormat != "") return inputPixelFormat;
+        return "rgba";
+    }
+    if (inputPixelFormat != "") return inputPixelFormat;
+    return "yuv420p";
+}
+
+QString FFMemoryEstimator::option(FFMediaInfo *media, QString name)
+{
+    foreach(QStringList opt,media->ffmpegOptions())
+    {
+        if (opt.count() < 2) continue;
+        if (opt[0] == name) return opt[1];
+    }
+    return "";
+}
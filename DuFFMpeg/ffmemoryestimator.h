@@ -0,0 +1,70 @@
+#ifndef FFMEMORYESTIMATOR_H
+#define FFMEMORYESTIMATOR_H
+
+#include "ffobject.h"
+
+#include <QHash>
+#include <QThread>
+#include <QRegularExpression>
+
+#include "ffqueueitem.h"
+#include "ffprocessmonitor.h"
+
+class FFMemoryEstimator : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFMemoryEstimator(QObject *parent = nullptr);
+
+    /**
+     * @brief estimate Estimates the peak resident memory the FFmpeg process will use to encode the item
+     * The estimation uses the resolution, pixel format, codec and number of threads of the inputs and outputs,
+     * corrected with the peak memory measured on the previous items encoded with the same codec
+     * @param item The queue item
+     * @return The estimated peak memory, in bytes
+     */
+    qint64 estimate(FFQueueItem *item);
+    /**
+     * @brief addSample Refines the model with the peak memory measured for an item which has been encoded
+     * @param item The queue item
+     * @param peakMemory The peak resident memory of the process, in bytes
+     */
+    void addSample(FFQueueItem *item, qint64 peakMemory);
+    /**
+     * @brief totalMemory Reads the physical memory of the system from /proc/meminfo
+     * @return The memory in bytes, or -1 if it is not available
+     */
+    static qint64 totalMemory();
+
+private:
+    /**
+     * @brief _corrections The ratio between the measured and the modeled memory, by codec
+     */
+    QHash<QString,double> _corrections;
+    /**
+     * @brief modelEstimate The raw estimation from the model, without correction
+     */
+    qint64 modelEstimate(FFQueueItem *item);
+    /**
+     * @brief modelKey The key used to store the corrections for the item (the first video codec)
+     */
+    QString modelKey(FFQueueItem *item);
+    /**
+     * @brief bytesPerPixel The memory needed to store one pixel in the given pixel format
+     */
+    static double bytesPerPixel(QString pixelFormat);
+    /**
+     * @brief bufferedFrames The number of frames an encoder keeps in memory
+     */
+    static int bufferedFrames(QString codec, int threads);
+    /**
+     * @brief defaultPixelFormat The pixel format used by default by an encoder
+     */
+    static QString defaultPixelFormat(QString codec, QString inputPixelFormat);
+    /**
+     * @brief option Gets the value of an FFmpeg option set on the media
+     */
+    static QString option(FFMediaInfo *media, QString name);
+};
+
+#endif // FFMEMORYESTIMATOR_H
@@ -0,0 +1,123 @@
+#include "ffmetrics.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+//two hours at one sample per second
+#define MAX_SAMPLES 7200
+
+FFMetrics::FFMetrics(QObject *parent) : FFObject(parent)
+{
+    _interval = 1;
+    _skipped = 0;
+}
+
+void FFMetrics::addSample(const FFMetricsSample &sample)
+{
+    //keep one sample every _interval
+    _skipped++;
+    if (_skipped < _interval) return;
+    _skipped = 0;
+    _samples << sample;
+
+    //full: halve the resolution, the series keeps covering the whole encoding
+    if (_samples.count() < MAX_SAMPLES) return;
+    QList<FFMetricsSample> samples;
+    samples.reserve(_samples.count() / 2 + 1);
+    for (int i = 0 ; i < _samples.count() ; i += 2) samples << _samples.at(i);
+    _samples = samples;
+    _interval *= 2;
+}
+
+QList<FFMetricsSample> FFMetrics::samples() const
+{
+    return _samples;
+}
+
+int FFMetrics::count() const
+{
+    return _samples.count();
+}
+
+void FFMetrics::clear()
+{
+    _samples.clear();
+    _interval = 1;
+    _skipped = 0;
+}
+
+QList<double> FFMetrics::values(Metric metric) const
+{
+    QList<double> values;
+    values.reserve(_samples.count());
+    foreach(FFMetricsSample sample,_samples)
+    {
+        if (metric == Framerate) values << sample.fps;
+        else if (metric == Speed) values << sample.speed;
+        else if (metric == Bitrate) values << sample.bitrate;
+        else if (metric == Quality) values << sample.quality;
+        else if (metric == Size) values << sample.size;
+        else if (metric == DuplicatedFrames) values << sample.dupFrames;
+        else if (metric == DroppedFrames) values << sample.dropFrames;
+    }
+    return values;
+}
+
+QString FFMetrics::toCsv() const
+{
+    QString csv = "time,frame,fps,speed,bitrate,q,size,dup_frames,drop_frames\n";
+    foreach(FFMetricsSample sample,_samples)
+    {
+        QStringList fields;
+        fields << QString::number(sample.time / 1000.0,'f',3);
+        fields << QString::number(sample.frame);
+        fields << QString::number(sample.fps);
+        fields << QString::number(sample.speed);
+        fields << QString::number(sample.bitrate,'f',0);
+        fields << QString::number(sample.quality);
+        fields << QString::number(sample.size);
+        fields << QString::number(sample.dupFrames);
+        fields << QString::number(sample.dropFrames);
+        csv += fields.join(",") + "\n";
+    }
+    return csv;
+}
+
+QJsonArray FFMetrics::toJson() const
+{
+    QJsonArray series;
+    foreach(FFMetricsSample sample,_samples)
+    {
+        QJsonObject s;
+        s.insert("time",sample.time / 1000.0);
+        s.insert("frame",sample.frame);
+        s.insert("fps",sample.fps);
+        s.insert("speed",sample.speed);
+        s.insert("bitrate",sample.bitrate);
+        s.insert("q",sample.quality);
+        s.insert("size",sample.size);
+        s.insert("dupFrames",sample.dupFrames);
+        s.insert("dropFrames",sample.dropFrames);
+        series.append(s);
+    }
+    return series;
+}
+
+bool FFMetrics::exportToFile(QString fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+#ifdef QT_DEBUG
+        qDebug() << "Cannot write the metrics file" << fileName;
+#endif
+        return false;
+    }
+
+    if (QFileInfo(fileName).suffix().toLower() == "json") file.write(QJsonDocument(toJson()).toJson());
+    else file.write(toCsv().toUtf8());
+
+    file.close();
+    return true;
+}
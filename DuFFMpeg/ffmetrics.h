@@ -0,0 +1,93 @@
+#ifndef FFMETRICS_H
+#define FFMETRICS_H
+
+#include "ffobject.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+/**
+ * @brief The FFMetricsSample struct The stats of an encoding at a given time
+ */
+struct FFMetricsSample
+{
+    /**
+     * @brief time The time since the encoding started, in milliseconds
+     */
+    qint64 time = 0;
+    int frame = 0;
+    double fps = 0.0;
+    double speed = 0.0;
+    /**
+     * @brief bitrate The average bitrate of the output, in bits/s
+     */
+    double bitrate = 0.0;
+    /**
+     * @brief quality The quantizer of the first output stream (q)
+     */
+    double quality = 0.0;
+    /**
+     * @brief size The size of the output, in bytes
+     */
+    qint64 size = 0;
+    int dupFrames = 0;
+    int dropFrames = 0;
+};
+
+/**
+ * @brief The FFMetrics class The time series of the stats of an encoding, recorded at a fixed interval
+ * Used to find the slowdowns happening during an encoding, and to compare presets.
+ * The number of samples is bounded: when the series is full, every other sample is dropped and the interval doubles.
+ */
+class FFMetrics : public FFObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief The Metric enum The values which can be extracted from the series
+     */
+    enum Metric { Framerate, Speed, Bitrate, Quality, Size, DuplicatedFrames, DroppedFrames };
+    Q_ENUM(Metric)
+
+    explicit FFMetrics(QObject *parent = nullptr);
+
+    void addSample(const FFMetricsSample &sample);
+    QList<FFMetricsSample> samples() const;
+    int count() const;
+    void clear();
+    /**
+     * @brief values Gets the values of one metric, in the order they were recorded
+     */
+    QList<double> values(Metric metric) const;
+    /**
+     * @brief toCsv Gets the series as CSV, with a header line
+     */
+    QString toCsv() const;
+    /**
+     * @brief toJson Gets the series as an array of objects
+     */
+    QJsonArray toJson() const;
+    /**
+     * @brief exportToFile Writes the series to a file
+     * @param fileName The file, written as JSON if its extension is .json, as CSV otherwise
+     * @return true if the file has been written
+     */
+    bool exportToFile(QString fileName) const;
+
+private:
+    QList<FFMetricsSample> _samples;
+    /**
+     * @brief _interval One sample is kept every _interval samples added
+     */
+    int _interval;
+    /**
+     * @brief _skipped The samples added since the latest one which has been kept
+     */
+    int _skipped;
+};
+
+#endif // FFMETRICS_H
@@ -0,0 +1,192 @@
+#include "ffmetricsexporter.h"
+
+#include "ffmpeg.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFMetricsExporter::FFMetricsExporter(FFmpeg *ffmpeg, QObject *parent) : FFObject(parent)
+{
+    _ffmpeg = ffmpeg;
+    _finishedFrames = 0;
+    _finishedBytes = 0;
+    _speedBuckets << 0.1 << 0.25 << 0.5 << 1 << 2 << 4 << 8 << 16;
+
+    _server = new QTcpServer(this);
+    connect(_server,SIGNAL(newConnection()),this,SLOT(newConnection()));
+    connect(_ffmpeg,SIGNAL(encodingFinished(FFQueueItem*)),this,SLOT(encodingFinished(FFQueueItem*)));
+}
+
+int FFMetricsExporter::port() const
+{
+    if (!_server->isListening()) return 0;
+    return _server->serverPort();
+}
+
+bool FFMetricsExporter::setPort(int port)
+{
+    if (port == this->port()) return true;
+    _server->close();
+    if (port <= 0) return true;
+
+    if (!_server->listen(QHostAddress::LocalHost,port))
+    {
+#ifdef QT_DEBUG
+        qDebug() << "Cannot start the metrics server" << _server->errorString();
+#endif
+        return false;
+    }
+    return true;
+}
+
+QString FFMetricsExporter::metrics()
+{
+    QList<FFQueueItem *> running = _ffmpeg->getRunningItems();
+
+    //current rates and totals, from the running items
+    qint64 frames = _finishedFrames;
+    qint64 bytes = _finishedBytes;
+    double framesPerSecond = 0.0;
+    double bytesPerSecond = 0.0;
+    foreach(FFQueueItem *item,running)
+    {
+        frames += item->currentFrame();
+        bytes += item->outputSize();
+        framesPerSecond += item->encodingFramerate();
+        //the bitrate is relative to the duration of the media, the speed converts it to real time
+        bytesPerSecond += item->outputBitrate() / 8 * item->encodingSpeed();
+    }
+
+    QString m;
+    m += metric("duffmpeg_queue_length","gauge","Items waiting in the queue.",QString::number(_ffmpeg->getQueueLength()));
+    m += metric("duffmpeg_running_jobs","gauge","FFmpeg processes currently encoding.",QString::number(_ffmpeg->getRunningProcessesCount()));
+    m += metric("duffmpeg_max_running_jobs","gauge","Maximum number of FFmpeg processes encoding at the same time.",QString::number(_ffmpeg->getMaxRunningJobs()));
+    m += metric("duffmpeg_jobs_finished_total","counter","Encodings which exited successfully.",QString::number(_ffmpeg->getFinishedJobsCount()));
+    m += metric("duffmpeg_jobs_failed_total","counter","Encodings which exited with an error or crashed.",QString::number(_ffmpeg->getFailedJobsCount()));
+    m += metric("duffmpeg_encoded_frames_total","counter","Frames encoded.",QString::number(frames));
+    m += metric("duffmpeg_written_bytes_total","counter","Bytes written to the outputs.",QString::number(bytes));
+    m += metric("duffmpeg_frames_per_second","gauge","Frames encoded per second by the running processes.",QString::number(framesPerSecond));
+    m += metric("duffmpeg_bytes_per_second","gauge","Bytes written per second by the running processes.",QString::number(bytesPerSecond,'f',0));
+    m += metric("duffmpeg_memory_projected_bytes","gauge","Peak memory expected for the running processes.",QString::number(_ffmpeg->getProjectedMemory()));
+
+    //speed histograms
+    m += "# HELP duffmpeg_encoding_speed Speed of the finished encodings, relative to the duration of the media.\n";
+    m += "# TYPE duffmpeg_encoding_speed histogram\n";
+    QMapIterator<QString, Histogram> i(_speedHistograms);
+    while (i.hasNext())
+    {
+        i.next();
+        QString codec = i.key();
+        //the buckets are cumulative
+        qint64 cumulative = 0;
+        for (int b = 0 ; b < _speedBuckets.count() ; b++)
+        {
+            cumulative += i.value().buckets.at(b);
+            m += "duffmpeg_encoding_speed_bucket{codec=\"" + codec + "\",le=\"" + QString::number(_speedBuckets.at(b)) + "\"} " + QString::number(cumulative) + "\n";
+        }
+        m += "duffmpeg_encoding_speed_bucket{codec=\"" + codec + "\",le=\"+Inf\"} " + QString::number(i.value().count) + "\n";
+        m += "duffmpeg_encoding_speed_sum{codec=\"" + codec + "\"} " + QString::number(i.value().sum) + "\n";
+        m += "duffmpeg_encoding_speed_count{codec=\"" + codec + "\"} " + QString::number(i.value().count) + "\n";
+    }
+
+    return m;
+}
+
+void FFMetricsExporter::encodingFinished(FFQueueItem *item)
+{
+    _finishedFrames += item->currentFrame();
+    _finishedBytes += item->outputSize();
+
+    //only the complete encodings give a meaningful speed
+    if (item->getStatus() != FFQueueItem::Finished) return;
+    if (item->encodingSpeed() <= 0) return;
+
+    QString codec = codecName(item);
+    Histogram histogram = _speedHistograms.value(codec);
+    if (histogram.buckets.count() == 0) for (int b = 0 ; b < _speedBuckets.count() ; b++) histogram.buckets << 0;
+    for (int b = 0 ; b < _speedBuckets.count() ; b++)
+    {
+        if (item->encodingSpeed() <= _speedBuckets.at(b))
+        {
+            histogram.buckets[b]++;
+            break;
+        }
+    }
+    histogram.sum += item->encodingSpeed();
+    histogram.count++;
+    _speedHistograms.insert(codec,histogram);
+}
+
+void FFMetricsExporter::newConnection()
+{
+    while (_server->hasPendingConnections())
+    {
+        QTcpSocket *socket = _server->nextPendingConnection();
+        _requests.insert(socket,QByteArray());
+        connect(socket,SIGNAL(readyRead()),this,SLOT(readRequest()));
+        connect(socket,SIGNAL(disconnected()),this,SLOT(clientDisconnected()));
+        connect(socket,SIGNAL(disconnected()),socket,SLOT(deleteLater()));
+    }
+}
+
+void FFMetricsExporter::readRequest()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (socket == nullptr || !_requests.contains(socket)) return;
+
+    QByteArray request = _requests.value(socket) + socket->readAll();
+    //wait for the end of the headers, but don't keep garbage forever
+    if (!request.contains("\r\n\r\n") && request.count() < 8192)
+    {
+        _requests.insert(socket,request);
+        return;
+    }
+    _requests.remove(socket);
+
+    QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    QByteArray status = "200 OK";
+    QByteArray body;
+    if (requestLine.count() < 2 || requestLine.at(0) != "GET") status = "405 Method Not Allowed";
+    else if (requestLine.at(1) != "/metrics" && requestLine.at(1) != "/") status = "404 Not Found";
+    else body = metrics().toUtf8();
+
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    response += "Content-Length: " + QByteArray::number(body.count()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+void FFMetricsExporter::clientDisconnected()
+{
+    _requests.remove(qobject_cast<QTcpSocket *>(sender()));
+}
+
+QString FFMetricsExporter::codecName(FFQueueItem *item)
+{
+    foreach(FFMediaInfo *output,item->getOutputMedias())
+    {
+        if (output->hasVideo())
+        {
+            if (output->videoCodec() == nullptr) return "default";
+            return output->videoCodec()->name();
+        }
+    }
+    foreach(FFMediaInfo *output,item->getOutputMedias())
+    {
+        if (output->hasAudio())
+        {
+            if (output->audioCodec() == nullptr) return "default";
+            return output->audioCodec()->name();
+        }
+    }
+    return "none";
+}
+
+QString FFMetricsExporter::metric(QString name, QString type, QString help, QString value)
+{
+    return "# HELP " + name + " " + help + "\n# TYPE " + name + " " + type + "\n" + name + " " + value + "\n";
+}
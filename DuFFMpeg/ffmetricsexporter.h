@@ -0,0 +1,85 @@
+#ifndef FFMETRICSEXPORTER_H
+#define FFMETRICSEXPORTER_H
+
+#include "ffobject.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QMap>
+
+#include "ffqueueitem.h"
+
+class FFmpeg;
+
+/**
+ * @brief The FFMetricsExporter class Serves the state of the queue and the encodings in the Prometheus text format,
+ * at http://127.0.0.1:<port>/metrics
+ * The server only listens on the local interface, the metrics are built from the state of FFmpeg each time they are scraped.
+ */
+class FFMetricsExporter : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFMetricsExporter(FFmpeg *ffmpeg, QObject *parent = nullptr);
+
+    /**
+     * @brief metrics Builds the metrics in the Prometheus text format
+     */
+    QString metrics();
+    /**
+     * @brief port The port the server listens on, 0 if it is disabled
+     */
+    int port() const;
+
+public slots:
+    /**
+     * @brief setPort Starts or stops the server
+     * @param port The port to listen on, 0 to disable the server
+     * @return false if the server could not listen on the port
+     */
+    bool setPort(int port);
+
+private slots:
+    /**
+     * @brief encodingFinished Adds the stats of a finished item to the totals and the speed histograms
+     */
+    void encodingFinished(FFQueueItem *item);
+    void newConnection();
+    void readRequest();
+    void clientDisconnected();
+
+private:
+    FFmpeg *_ffmpeg;
+    QTcpServer *_server;
+    /**
+     * @brief _requests The data received from each client, until the request is complete
+     */
+    QMap<QTcpSocket *, QByteArray> _requests;
+    //totals of the finished items, the running ones are added when the metrics are built
+    qint64 _finishedFrames;
+    qint64 _finishedBytes;
+    /**
+     * @brief The Histogram struct The distribution of the encoding speeds of a codec
+     */
+    struct Histogram {
+        QList<qint64> buckets;
+        double sum = 0.0;
+        qint64 count = 0;
+    };
+    QMap<QString, Histogram> _speedHistograms;
+    /**
+     * @brief _speedBuckets The upper bounds of the buckets of the histograms
+     */
+    QList<double> _speedBuckets;
+    /**
+     * @brief codecName The name of the main codec of an item, used to label its metrics
+     */
+    QString codecName(FFQueueItem *item);
+    /**
+     * @brief metric Formats a metric with its help and type
+     */
+    QString metric(QString name, QString type, QString help, QString value);
+};
+
+#endif // FFMETRICSEXPORTER_H
@@ -11,13 +11,53 @@ FFmpeg::FFmpeg(QString path,QObject *parent) : FFObject(parent)
     _lastError = QProcess::UnknownError;
 
     _ffmpeg = new QProcess(this);
-    setBinaryFileName(path);
-
-    _currentFrame = 0;
-    _startTime = QTime(0,0,0);
-    _outputSize = 0.0;
-    _outputBitrate = 0;
-    _encodingSpeed = 0.0;
+    _helpProcess = nullptr;
+
+    _currentItem = nullptr;
+    _lastJobId = 0;
+    _finishedJobs = 0;
+    _failedJobs = 0;
+    _maxRunningJobs = 1;
+    _memoryBudget = 0;
+    _outputBufferSize = 1024*1024;
+    _benchmarkEnabled = false;
+    _followCompletion = FFFrameFeeder::StableSize;
+    _followTimeout = 60;
+    _prefetchThreads = 0;
+    _prefetchDepth = 16;
+    _batchProcesses = 1;
+    _mezzaninePath = "";
+    _jobLogsPath = "";
+    _logThread = new QThread(this);
+    _logWriter = new FFLogWriter();
+    _logWriter->moveToThread(_logThread);
+    connect(_logThread,SIGNAL(finished()),_logWriter,SLOT(deleteLater()));
+    _logThread->start();
+    _cacheBudget = 0;
+    _warmedItem = nullptr;
+    _cacheThread = new QThread(this);
+    _cacheWarmer = new FFCacheWarmer();
+    _cacheWarmer->moveToThread(_cacheThread);
+    connect(_cacheThread,SIGNAL(finished()),_cacheWarmer,SLOT(deleteLater()));
+    connect(_cacheWarmer,SIGNAL(debugInfo(QString)),this,SIGNAL(debugInfo(QString)));
+    _cacheThread->start();
+    _memoryEstimator = new FFMemoryEstimator(this);
+    _telemetryTimer = new QTimer(this);
+    _telemetryTimer->setInterval(1000);
+    connect(_telemetryTimer,SIGNAL(timeout()),this,SLOT(sampleProcesses()));
+    _progressPending = false;
+    _progressTimer = new QTimer(this);
+    setProgressRate(8);
+    connect(_progressTimer,SIGNAL(timeout()),this,SLOT(emitProgress()));
+    FFTrace::setTrackName(0,"Queue");
+    _metricsExporter = new FFMetricsExporter(this,this);
+
+    //errors are sent by the workers through queued connections
+    qRegisterMetaType<QProcess::ProcessError>("QProcess::ProcessError");
+    qRegisterMetaType<FFProgress>("FFProgress");
+    qRegisterMetaType<FFBenchmark>("FFBenchmark");
+    qRegisterMetaType<FFFrameFeeder*>("FFFrameFeeder*");
+    qRegisterMetaType<FFBatch>("FFBatch");
 
     //Connect process
     connect(_ffmpeg,SIGNAL(readyReadStandardError()),this,SLOT(stdError()));
@@ -29,7 +69,23 @@ FFmpeg::FFmpeg(QString path,QObject *parent) : FFObject(parent)
 #ifdef QT_DEBUG
     qDebug() << "FFmpeg - Initialization";
 #endif
-    init();
+    //once the process is connected, its output is needed by init()
+    if (!setBinaryFileName(path)) init();
+}
+
+FFmpeg::~FFmpeg()
+{
+    //the workers are deleted with their threads
+    foreach(QThread *thread,_workerThreads)
+    {
+        thread->quit();
+        thread->wait();
+    }
+    //let the writer finish writing the logs
+    _logThread->quit();
+    _logThread->wait();
+    _cacheThread->quit();
+    _cacheThread->wait();
 }
 
 bool FFmpeg::setBinaryFileName(QString path)
@@ -53,8 +109,7 @@ bool FFmpeg::setBinaryFileName(QString path)
 void FFmpeg::runCommand(QString commands)
 {
     //detect arguments
-    QRegularExpression re("(\"[^\"]*\"|[\\S]+)");
-    QRegularExpressionMatchIterator i = re.globalMatch(commands);
+    QRegularExpressionMatchIterator i = FFOutputParser::regExp(FFOutputParser::Argument).globalMatch(commands);
     QStringList commandList;
     while (i.hasNext()) {
         QRegularExpressionMatch match = i.next();
@@ -89,23 +144,9 @@ void FFmpeg::init()
         gotMuxers(_ffmpegOutput);
     }
 
-    //get long help
-    QStringList args("-h");
-    args << "long";
-    _ffmpeg->setArguments(args);
-    _ffmpeg->start(QIODevice::ReadOnly);
-    if (_ffmpeg->waitForFinished(3000))
-    {
-        _longHelp = _ffmpegOutput;
-    }
-
-    //get help
-    _ffmpeg->setArguments(QStringList("-h"));
-    _ffmpeg->start(QIODevice::ReadOnly);
-    if (_ffmpeg->waitForFinished(3000))
-    {
-        _help = _ffmpegOutput;
-    }
+    //the help is loaded the first time it is needed
+    _help = "";
+    _longHelp = "";
 }
 
 QList<FFMuxer *> FFmpeg::getMuxers()
@@ -178,16 +219,72 @@ FFCodec *FFmpeg::getAudioEncoder(QString name)
 
 QString FFmpeg::getHelp()
 {
+    if (_help == "")
+    {
+        _ffmpeg->setArguments(QStringList("-h"));
+        _ffmpeg->start(QIODevice::ReadOnly);
+        if (_ffmpeg->waitForFinished(3000)) _help = _ffmpegOutput;
+    }
     return _help;
 }
 
 QString FFmpeg::getLongHelp()
 {
+    if (_longHelp == "")
+    {
+        QStringList args("-h");
+        args << "long";
+        _ffmpeg->setArguments(args);
+        _ffmpeg->start(QIODevice::ReadOnly);
+        if (_ffmpeg->waitForFinished(3000)) _longHelp = _ffmpegOutput;
+    }
     return _longHelp;
 }
 
+void FFmpeg::loadLongHelp()
+{
+    if (_longHelp != "")
+    {
+        emit longHelpLoaded(_longHelp);
+        return;
+    }
+    //already loading
+    if (_helpProcess != nullptr) return;
+
+    //the help is long, it's not waited for
+    _helpProcess = new QProcess(this);
+    _helpProcess->setProgram(_ffmpeg->program());
+    QStringList args("-h");
+    args << "long";
+    _helpProcess->setArguments(args);
+    _helpProcess->setProcessChannelMode(QProcess::MergedChannels);
+    connect(_helpProcess,SIGNAL(finished(int)),this,SLOT(longHelpFinished()));
+    connect(_helpProcess,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(longHelpFinished()));
+    _helpProcess->start(QIODevice::ReadOnly);
+}
+
+void FFmpeg::longHelpFinished()
+{
+    if (_helpProcess == nullptr) return;
+    //the process will not emit finished if it could not start
+    if (_helpProcess->state() != QProcess::NotRunning) return;
+
+    if (_helpProcess->exitStatus() == QProcess::NormalExit && _helpProcess->error() != QProcess::FailedToStart)
+    {
+        _longHelp = QString::fromUtf8(_helpProcess->readAll());
+    }
+    _helpProcess->deleteLater();
+    _helpProcess = nullptr;
+
+    if (_longHelp != "") emit longHelpLoaded(_longHelp);
+}
+
 FFMediaInfo *FFmpeg::getMediaInfo(QString mediaPath)
 {
+    FFMediaInfo *sequenceInfo = new FFMediaInfo("",this);
+    if (sequenceInfo->loadImageSequence(mediaPath)) return sequenceInfo;
+    delete sequenceInfo;
+
     QString infoString = getMediaInfoString(mediaPath);
     if (infoString == "") return new FFMediaInfo("",this);
     FFMediaInfo *info = new FFMediaInfo(infoString,this);
@@ -196,56 +293,59 @@ FFMediaInfo *FFmpeg::getMediaInfo(QString mediaPath)
 
 QString FFmpeg::getMediaInfoString(QString mediaPath)
 {
+    qint64 traceStart = FFTrace::now();
+    QJsonObject traceArgs;
+    traceArgs.insert("path",mediaPath);
+
     QStringList args("-i");
     args << QDir::toNativeSeparators(mediaPath);
     _ffmpeg->setArguments(args);
     _ffmpeg->start(QIODevice::ReadOnly);
-    if (_ffmpeg->waitForFinished(3000))
-    {
-        return _ffmpegOutput;
-    }
+    bool ok = _ffmpeg->waitForFinished(3000);
+    FFTrace::span("probe","probe",0,traceStart,traceArgs);
+    if (ok) return _ffmpegOutput;
     return "";
 }
 
 int FFmpeg::getCurrentFrame()
 {
-    return _currentFrame;
+    if (_currentItem == nullptr) return 0;
+    return _currentItem->currentFrame();
 }
 
 QTime FFmpeg::getStartTime()
 {
-    return _startTime;
+    if (_currentItem == nullptr) return QTime(0,0,0);
+    return _currentItem->startTime();
 }
 
 QTime FFmpeg::getElapsedTime()
 {
-    return QTime(0,0,0).addSecs(_startTime.elapsed() / 1000);
+    return QTime(0,0,0).addSecs(getStartTime().elapsed() / 1000);
 }
 
 double FFmpeg::getOutputSize(FFMediaInfo::SizeUnit unit)
 {
-    double s = _outputSize;
-    if (unit == FFMediaInfo::KB) s = s/1024;
-    if (unit == FFMediaInfo::MB) s = s/1024/1024;
-    return s;
+    if (_currentItem == nullptr) return 0.0;
+    return _currentItem->outputSize(unit);
 }
 
 double FFmpeg::getOutputBitrate(FFMediaInfo::BitrateUnit unit)
 {
-    double bitrate = _outputBitrate;
-    if (unit == FFMediaInfo::Kbps) bitrate = bitrate/1024;
-    if (unit == FFMediaInfo::Mbps) bitrate = bitrate/1024/1024;
-    return bitrate;
+    if (_currentItem == nullptr) return 0.0;
+    return _currentItem->outputBitrate(unit);
 }
 
 double FFmpeg::getEncodingSpeed()
 {
-    return _encodingSpeed;
+    if (_currentItem == nullptr) return 0.0;
+    return _currentItem->encodingSpeed();
 }
 
 QTime FFmpeg::getTimeRemaining()
 {
-    return _timeRemaining;
+    if (_currentItem == nullptr) return QTime(0,0,0);
+    return _currentItem->timeRemaining();
 }
 
 FFQueueItem *FFmpeg::getCurrentItem()
@@ -253,6 +353,143 @@ FFQueueItem *FFmpeg::getCurrentItem()
     return _currentItem;
 }
 
+QList<FFQueueItem *> FFmpeg::getRunningItems()
+{
+    return _runningJobs.values();
+}
+
+int FFmpeg::getMaxRunningJobs()
+{
+    return _maxRunningJobs;
+}
+
+int FFmpeg::getRunningProcessesCount()
+{
+    int processes = 0;
+    foreach(int jobProcesses,_jobProcesses) processes += jobProcesses;
+    return processes;
+}
+
+qint64 FFmpeg::getMemoryBudget()
+{
+    if (_memoryBudget > 0) return _memoryBudget;
+    if (_memoryBudget < 0) return 0;
+    //auto: keep some room for the system and the other applications
+    qint64 total = FFMemoryEstimator::totalMemory();
+    if (total <= 0) return 0;
+    return total * 0.8;
+}
+
+qint64 FFmpeg::getProjectedMemory()
+{
+    qint64 projected = 0;
+    foreach(FFQueueItem *item,_runningJobs)
+    {
+        //the measured memory replaces the estimation if the process uses more than expected
+        projected += std::max(item->estimatedMemory(),item->peakMemory());
+    }
+    return projected;
+}
+
+int FFmpeg::getQueueLength()
+{
+    return _encodingQueue.count();
+}
+
+int FFmpeg::getFinishedJobsCount()
+{
+    return _finishedJobs;
+}
+
+int FFmpeg::getFailedJobsCount()
+{
+    return _failedJobs;
+}
+
+void FFmpeg::setMaxRunningJobs(int maxRunningJobs)
+{
+    if (maxRunningJobs < 1) maxRunningJobs = 1;
+    _maxRunningJobs = maxRunningJobs;
+    //there may be room for more items
+    if (_status == Encoding) encodeNextItem();
+}
+
+void FFmpeg::setMemoryBudget(qint64 memoryBudget)
+{
+    _memoryBudget = memoryBudget;
+    if (_status == Encoding) encodeNextItem();
+}
+
+void FFmpeg::setOutputBufferSize(int size)
+{
+    //used for the next encodings
+    _outputBufferSize = size;
+}
+
+void FFmpeg::setJobLogsPath(QString path)
+{
+    _jobLogsPath = path;
+}
+
+void FFmpeg::setLogsMaxSize(qint64 size)
+{
+    QMetaObject::invokeMethod(_logWriter,"setMaxFileSize",Qt::QueuedConnection,Q_ARG(qint64,size));
+}
+
+void FFmpeg::setProgressRate(int rate)
+{
+    if (rate < 1) rate = 1;
+    _progressTimer->setInterval(1000/rate);
+}
+
+void FFmpeg::setBenchmarkEnabled(bool enabled)
+{
+    _benchmarkEnabled = enabled;
+}
+
+void FFmpeg::setFollowCompletion(int completion)
+{
+    _followCompletion = FFFrameFeeder::Completion(completion);
+}
+
+void FFmpeg::setFollowTimeout(int timeout)
+{
+    _followTimeout = timeout;
+}
+
+void FFmpeg::setPrefetchThreads(int threads)
+{
+    _prefetchThreads = threads;
+}
+
+void FFmpeg::setPrefetchDepth(int depth)
+{
+    _prefetchDepth = depth;
+}
+
+void FFmpeg::setBatchProcesses(int processes)
+{
+    _batchProcesses = processes;
+}
+
+void FFmpeg::setMezzaninePath(QString path)
+{
+    _mezzaninePath = path;
+    if (path != "") QDir().mkpath(path);
+}
+
+void FFmpeg::setCacheBudget(qint64 budget)
+{
+    _cacheBudget = budget;
+    _warmedItem = nullptr;
+}
+
+void FFmpeg::setMetricsPort(int port)
+{
+    if (!_metricsExporter->setPort(port)) emit debugInfo("Cannot start the metrics server on port " + QString::number(port));
+    else if (port > 0) emit debugInfo("Metrics available at http://127.0.0.1:" + QString::number(port) + "/metrics");
+}
+
 QProcess::ProcessError FFmpeg::getLastError()
 {
     return _lastError;
@@ -270,10 +507,19 @@ FFmpeg::Status FFmpeg::getStatus()
 
 void FFmpeg::encode()
 {
-    if (_status == Encoding) return;
-    setStatus(Encoding);
+    //already encoding: the new items are launched if there's room for them
+    if (_status != Encoding) setStatus(Encoding);
 
-    //launch first item
+    //the items start waiting
+    if (FFTrace::isEnabled())
+    {
+        foreach(FFQueueItem *item,_encodingQueue)
+        {
+            if (!_queuedTimes.contains(item)) _queuedTimes.insert(item,FFTrace::now());
+        }
+    }
+
+    //launch first items
     encodeNextItem();
 }
 
@@ -311,13 +557,15 @@ int FFmpeg::addQueueItem(FFQueueItem *item)
 
 void FFmpeg::removeQueueItem(int id)
 {
-    FFQueueItem *i = _encodingQueue.takeAt(id);
+    FFQueueItem *i = takeQueueItem(id);
     delete i;
 }
 
 FFQueueItem *FFmpeg::takeQueueItem(int id)
 {
-    return _encodingQueue.takeAt(id);
+    FFQueueItem *i = _encodingQueue.takeAt(id);
+    _queuedTimes.remove(i);
+    return i;
 }
 
 void FFmpeg::clearQueue()
@@ -330,13 +578,26 @@ void FFmpeg::clearQueue()
 
 void FFmpeg::stop(int timeout)
 {
-    if (_ffmpeg->state() == QProcess::NotRunning) return;
-    _ffmpeg->write("q\n");
-    if (!_ffmpeg->waitForFinished(timeout))
+    if (_runningJobs.count() == 0) return;
+    //do not launch the next items
+    setStatus(Waiting);
+    //all processes are stopped at the same time
+    foreach(int id,_runningJobs.keys())
     {
-        _ffmpeg->kill();
+        if (_stoppingJobs.contains(id)) continue;
+        _stoppingJobs << id;
+
+        _runningJobs.value(id)->setStatus(FFQueueItem::Stopped);
+
+        //the job is still reading the state of its frames, it has no process yet
+        if (_keyWatchers.values().contains(id))
+        {
+            endJob(id,-1);
+            continue;
+        }
+
+        QMetaObject::invokeMethod(_jobWorkers.value(id),"stopJob",Qt::QueuedConnection,Q_ARG(int,id),Q_ARG(int,timeout));
     }
-    setStatus(Waiting);
 }
 
 void FFmpeg::stdError()
@@ -358,21 +619,20 @@ void FFmpeg::started()
 
 void FFmpeg::finished()
 {
-    if (_status == Encoding)
-    {
-        _currentItem->setStatus(FFQueueItem::Finished);
-        emit encodingFinished(_currentItem);
-        //move to history
-        _encodingHistory << _currentItem;
-        encodeNextItem();
-    }
-    else
+    if (_status != Encoding)
     {
         setStatus(Waiting);
     }
 }
 
 void FFmpeg::errorOccurred(QProcess::ProcessError e)
+{
+    if (_status != Encoding) setStatus(Error);
+    _lastError = e;
+    emit processError(processErrorString(e));
+}
+
+QString FFmpeg::processErrorString(QProcess::ProcessError e)
 {
     QString error;
     if (e == QProcess::FailedToStart)
@@ -399,36 +659,589 @@ void FFmpeg::errorOccurred(QProcess::ProcessError e)
     {
         error = "An unknown error occured.";
     }
+    return error;
+}
+
+void FFmpeg::jobStarted(int id, qint64 pid)
+{
+    if (!_runningJobs.contains(id)) return;
+    bool first = !_jobProcessIds.contains(id);
+    _jobProcessIds[id] << pid;
+
+    //the first process has been spawned, the encoding starts
+    if (first && _jobSlots.contains(id))
+    {
+        QJsonObject traceArgs;
+        traceArgs.insert("job",id);
+        traceArgs.insert("pid",pid);
+        FFTrace::span("spawn","job",_jobSlots.value(id),_jobPhaseStarts.value(id),traceArgs);
+        _jobPhaseStarts.insert(id,FFTrace::now());
+    }
+
+    //first sample, the next ones measure the CPU usage from it
+    sampleJob(id);
+}
+
+void FFmpeg::jobProcessFinished(int id, qint64 pid)
+{
+    if (!_jobProcessIds.contains(id)) return;
+    _jobProcessIds[id].removeAll(pid);
+
+    //its totals are kept in the job ones, from its last sample
+    FFProcessSample last = _processSamples.take(pid);
+    if (!last.valid) return;
+    FFProcessSample ended = _jobEndedSamples.value(id);
+    ended.cpuTime += last.cpuTime;
+    ended.readBytes += last.readBytes;
+    ended.writtenBytes += last.writtenBytes;
+    ended.voluntaryContextSwitches += last.voluntaryContextSwitches;
+    ended.involuntaryContextSwitches += last.involuntaryContextSwitches;
+    _jobEndedSamples.insert(id,ended);
+}
+
+void FFmpeg::jobOutput(int id, QString output)
+{
+    FFQueueItem *item = _runningJobs.value(id,nullptr);
+    if (item == nullptr) return;
+    item->output()->append(output);
+    if (_jobLogFiles.contains(id)) writeLog(_jobLogFiles.value(id),output);
+    emit newJobOutput(item,output);
+}
+
+void FFmpeg::jobProgress(int id, FFProgress stats)
+{
+    FFQueueItem *item = _runningJobs.value(id,nullptr);
+    if (item == nullptr) return;
+
+    //only keep the latest stats, they're sent by emitProgress
+    item->setCurrentFrame(stats.frame);
+    item->setEncodingFramerate(stats.fps);
+    item->setOutputTime(stats.outTime);
+    item->setOutputSize(stats.totalSize);
+    item->setOutputBitrate(stats.bitrate);
+    item->setEncodingSpeed(stats.speed);
+    item->setDuplicatedFrames(stats.dupFrames);
+    item->setDroppedFrames(stats.dropFrames);
+    item->setQuality(stats.quality);
+
+    _progressPending = true;
+    if (!_progressTimer->isActive())
+    {
+        //first update after a pause: send it now
+        emitProgress();
+        _progressTimer->start();
+    }
+}
 
-    if (_status == Encoding)
+void FFmpeg::jobBenchmark(int id, FFBenchmark benchmark)
+{
+    FFQueueItem *item = _runningJobs.value(id,nullptr);
+    if (item == nullptr) return;
+    item->setBenchmark(benchmark);
+    emit debugInfo("Job " + QString::number(id) + " benchmark:\n" + FFBenchmarkParser::report(benchmark));
+}
+
+void FFmpeg::emitProgress()
+{
+    //nothing new, wait for the next stats
+    if (!_progressPending)
     {
-        _currentItem->setStatus(FFQueueItem::Stopped);
-        _encodingHistory << _currentItem;
+        _progressTimer->stop();
+        return;
+    }
+    _progressPending = false;
+
+    foreach(FFQueueItem *item,_runningJobs)
+    {
+        //time remaining
+        //gets the current item duration, using the encoded time works with audio only medias too
+        double duration = 0;
+        foreach(FFMediaInfo *input,item->getInputMedias())
+        {
+            if (input->duration() > duration) duration = input->duration();
+        }
+        double encoded = item->outputTime() / 1000000.0;
+        if (duration > 0 && encoded > 0)
+        {
+            int elapsed = item->startTime().elapsed() / 1000;
+            int remaining = elapsed*duration/encoded - elapsed;
+            if (remaining < 0) remaining = 0;
+            item->setTimeRemaining(QTime(0,0,0).addSecs(remaining));
+        }
+    }
+
+    emit progress();
+}
+
+void FFmpeg::jobError(int id, QProcess::ProcessError e)
+{
+    FFQueueItem *item = _runningJobs.value(id,nullptr);
+
+    bool failed = e == QProcess::FailedToStart || e == QProcess::Crashed;
+    if (failed && item != nullptr && item->getStatus() == FFQueueItem::InProgress)
+    {
+        //a stopped item is killed on purpose
+        item->setStatus(FFQueueItem::Stopped);
+        setStatus(Error);
     }
 
-    setStatus(Error);
     _lastError = e;
-    emit processError(error);
+    emit processError(processErrorString(e));
+
+    QJsonObject event;
+    event.insert("event","error");
+    event.insert("job",id);
+    event.insert("error",processErrorString(e));
+    logEvent(event);
+}
+
+void FFmpeg::jobFinished(int id, int exitCode)
+{
+    endJob(id,exitCode);
+}
+
+void FFmpeg::endJob(int id, int exitCode)
+{
+    qint64 traceStart = FFTrace::now();
+    int slot = _jobSlots.take(id);
+    if (slot > 0)
+    {
+        //a job which has not started has not encoded
+        QJsonObject traceArgs;
+        traceArgs.insert("job",id);
+        traceArgs.insert("exitCode",exitCode);
+        FFTrace::span(_jobProcessIds.contains(id) ? "encode" : "spawn","job",slot,_jobPhaseStarts.take(id),traceArgs);
+    }
+
+    //send the latest stats before the item is finished
+    if (_progressPending) emitProgress();
+
+    FFQueueItem *item = _runningJobs.take(id);
+    foreach(qint64 pid,_jobProcessIds.take(id)) _processSamples.remove(pid);
+    _jobProcesses.remove(id);
+    _jobEndedSamples.remove(id);
+    qint64 processPeak = _jobProcessPeaks.take(id);
+    _jobWorkers.remove(id);
+    bool wasStopping = _stoppingJobs.removeAll(id) > 0;
+    foreach(QString tempFile,_jobTempFiles.take(id)) QFile::remove(tempFile);
+    //the inputs won't be read again, they can leave the cache to the next ones,
+    //before the mezzanines are renamed: the queued items would read them instead of the frames
+    QStringList readFiles = _jobInputFiles.take(id);
+    if (_cacheBudget > 0 && readFiles.count() > 0)
+    {
+        //except the ones which are read by the other items
+        QSet<QString> used;
+        foreach(QStringList files,_jobInputFiles)
+        {
+            foreach(QString file,files) used.insert(file);
+        }
+        foreach(FFQueueItem *other,_encodingQueue)
+        {
+            foreach(QString file,inputFiles(other)) used.insert(file);
+        }
+        QStringList released;
+        foreach(QString file,readFiles)
+        {
+            if (!used.contains(file)) released << file;
+        }
+        if (released.count() > 0) QMetaObject::invokeMethod(_cacheWarmer,"release",Qt::QueuedConnection,Q_ARG(QStringList,released));
+    }
+    //a mezzanine is usable only if the encoding has succeeded
+    foreach(QString mezzanine,_jobMezzanines.take(id))
+    {
+        if (!wasStopping && exitCode == 0 && QFile::rename(mezzanine + ".part",mezzanine)) continue;
+        QFile::remove(mezzanine + ".part");
+    }
+    //stopped jobs are neither finished nor failed
+    if (!wasStopping && exitCode == 0) _finishedJobs++;
+    else if (!wasStopping) _failedJobs++;
+
+    if (_jobLogFiles.contains(id))
+    {
+        QString logFileName = _jobLogFiles.take(id);
+        writeLog(logFileName,"FFmpeg exited with code " + QString::number(exitCode) + "\n");
+        QMetaObject::invokeMethod(_logWriter,"close",Qt::QueuedConnection,Q_ARG(QString,logFileName));
+
+        //the metrics of the encoding, next to its log
+        if (item != nullptr && item->metrics()->count() > 0)
+        {
+            QString metricsFileName = logFileName.left(logFileName.count() - 4) + ".metrics.csv";
+            writeLog(metricsFileName,item->metrics()->toCsv());
+            QMetaObject::invokeMethod(_logWriter,"close",Qt::QueuedConnection,Q_ARG(QString,metricsFileName));
+        }
+    }
+
+    if (item != nullptr)
+    {
+        //refine the memory model with what has been measured, the model is for one process
+        //a stopped or failed encoding may not have reached its peak
+        if (!wasStopping && exitCode == 0) _memoryEstimator->addSample(item,processPeak);
+
+        //the end of the output explains why the encoding has failed
+        QString lastOutput = "";
+        if (!wasStopping && exitCode != 0)
+        {
+            QStringList lines = item->output()->text().trimmed().split("\n");
+            lastOutput = lines.mid(qMax(0,lines.count() - 20)).join("\n");
+            QString name = "the encoding";
+            if (item->getOutputMedias().count() > 0) name = QFileInfo(item->getOutputMedias()[0]->fileName()).fileName();
+            emit debugInfo("Warning: " + name + " failed, FFmpeg exited with code " + QString::number(exitCode) + ". Last output:\n" + lastOutput);
+        }
+        //a finished item stays in the history, only the end of its output is kept
+        item->output()->setCapacity(lastOutput.count());
+        item->output()->append(lastOutput);
+
+        //stopped or crashed items keep their status
+        if (item->getStatus() == FFQueueItem::InProgress) item->setStatus(FFQueueItem::Finished);
+
+        QJsonObject event;
+        event.insert("event","finish");
+        event.insert("job",id);
+        event.insert("status",item->getStatus() == FFQueueItem::Finished ? "finished" : "stopped");
+        event.insert("exitCode",exitCode);
+        if (lastOutput != "") event.insert("lastOutput",lastOutput);
+        event.insert("duration",item->startTime().elapsed() / 1000.0);
+        event.insert("frames",item->currentFrame());
+        event.insert("outputSize",item->outputSize());
+        event.insert("outputBitrate",item->outputBitrate());
+        event.insert("speed",item->encodingSpeed());
+        event.insert("duplicatedFrames",item->duplicatedFrames());
+        event.insert("droppedFrames",item->droppedFrames());
+        event.insert("estimatedMemory",item->estimatedMemory());
+        event.insert("peakMemory",item->peakMemory());
+        //process telemetry, from the last sample before the process exited
+        FFProcessSample sample = item->processSample();
+        event.insert("cpuTime",sample.cpuTime / 1000.0);
+        event.insert("averageCpu",item->averageCpuUsage());
+        event.insert("maxCpu",item->maxCpuUsage());
+        event.insert("readBytes",sample.readBytes);
+        event.insert("writtenBytes",sample.writtenBytes);
+        event.insert("voluntaryContextSwitches",sample.voluntaryContextSwitches);
+        event.insert("involuntaryContextSwitches",sample.involuntaryContextSwitches);
+        //profiling
+        FFBenchmark benchmark = item->benchmark();
+        if (benchmark.valid || benchmark.stages.count() > 0)
+        {
+            QJsonObject bench;
+            bench.insert("userTime",benchmark.userTime);
+            bench.insert("systemTime",benchmark.systemTime);
+            bench.insert("realTime",benchmark.realTime);
+            bench.insert("maxMemory",benchmark.maxMemory);
+            QJsonObject stages;
+            QMapIterator<QString, FFBenchmarkStage> s(benchmark.stages);
+            while (s.hasNext())
+            {
+                s.next();
+                QJsonObject stage;
+                stage.insert("userTime",s.value().userTime / 1000000.0);
+                stage.insert("systemTime",s.value().systemTime / 1000000.0);
+                stage.insert("realTime",s.value().realTime / 1000000.0);
+                stage.insert("count",s.value().count);
+                stages.insert(s.key(),stage);
+            }
+            bench.insert("stages",stages);
+            event.insert("benchmark",bench);
+        }
+        logEvent(event);
+
+        emit debugInfo("Job " + QString::number(id) + " resources: CPU " + QString::number(item->averageCpuUsage(),'f',0)
+                       + "% average, " + QString::number(item->maxCpuUsage(),'f',0) + "% max"
+                       + " | Peak memory " + QString::number(item->peakMemory() / 1024 / 1024) + " MB"
+                       + " | Read " + QString::number(sample.readBytes / 1024 / 1024) + " MB"
+                       + " | Written " + QString::number(sample.writtenBytes / 1024 / 1024) + " MB"
+                       + " | Context switches " + QString::number(sample.voluntaryContextSwitches)
+                       + " voluntary, " + QString::number(sample.involuntaryContextSwitches) + " involuntary");
+
+        emit encodingFinished(item);
+        //move to history
+        _encodingHistory << item;
+
+        //show another running item
+        if (_currentItem == item && _runningJobs.count() > 0) _currentItem = _runningJobs.last();
+    }
+
+    if (_runningJobs.count() == 0) _telemetryTimer->stop();
+    if (slot > 0) FFTrace::span("finalize","job",slot,traceStart);
+    if (wasStopping && _stoppingJobs.count() == 0) emit stopped();
+
+    if (_status == Encoding) encodeNextItem();
+}
+
+void FFmpeg::sampleProcesses()
+{
+    foreach(int id,_jobProcessIds.keys())
+    {
+        FFQueueItem *item = _runningJobs.value(id,nullptr);
+        if (item == nullptr) continue;
+        sampleJob(id);
+
+        //record the stats at the same interval
+        FFMetricsSample sample;
+        sample.time = item->startTime().elapsed();
+        sample.frame = item->currentFrame();
+        sample.fps = item->encodingFramerate();
+        sample.speed = item->encodingSpeed();
+        sample.bitrate = item->outputBitrate();
+        sample.quality = item->quality();
+        sample.size = item->outputSize();
+        sample.dupFrames = item->duplicatedFrames();
+        sample.dropFrames = item->droppedFrames();
+        item->metrics()->addSample(sample);
+    }
+    if (_jobProcessIds.count() > 0) emit telemetry();
+}
+
+void FFmpeg::sampleJob(int id)
+{
+    FFQueueItem *item = _runningJobs.value(id,nullptr);
+    if (item == nullptr) return;
+
+    //the processes of a batch which have finished still count in the totals
+    FFProcessSample jobSample = _jobEndedSamples.value(id);
+    qint64 processPeak = _jobProcessPeaks.value(id,0);
+    foreach(qint64 pid,_jobProcessIds.value(id))
+    {
+        FFProcessSample s = FFProcessMonitor::sample(pid,_processSamples.value(pid));
+        if (!s.valid) continue;
+        _processSamples.insert(pid,s);
+        jobSample.valid = true;
+        jobSample.time = s.time;
+        jobSample.cpuTime += s.cpuTime;
+        //the processes run at the same time, their memory adds up
+        jobSample.memory += s.memory;
+        jobSample.peakMemory += s.peakMemory;
+        jobSample.readBytes += s.readBytes;
+        jobSample.writtenBytes += s.writtenBytes;
+        jobSample.voluntaryContextSwitches += s.voluntaryContextSwitches;
+        jobSample.involuntaryContextSwitches += s.involuntaryContextSwitches;
+        jobSample.threads += s.threads;
+        processPeak = std::max(processPeak,s.peakMemory);
+    }
+    if (!jobSample.valid) return;
+    _jobProcessPeaks.insert(id,processPeak);
+
+    //CPU usage of all the processes since the previous sample
+    FFProcessSample previous = item->processSample();
+    if (previous.valid && jobSample.time > previous.time)
+    {
+        jobSample.cpuUsage = double(jobSample.cpuTime - previous.cpuTime) * 100.0 / (jobSample.time - previous.time);
+        if (jobSample.cpuUsage < 0) jobSample.cpuUsage = 0.0;
+    }
+    item->setProcessSample(jobSample);
+}
+
+FFProcessWorker *FFmpeg::getWorker()
+{
+    //one thread for every four jobs
+    int numWorkers = (_maxRunningJobs + 3) / 4;
+    if (_workers.count() < numWorkers)
+    {
+        QThread *thread = new QThread(this);
+        FFProcessWorker *worker = new FFProcessWorker();
+        worker->moveToThread(thread);
+        connect(thread,SIGNAL(finished()),worker,SLOT(deleteLater()));
+        connect(worker,SIGNAL(jobStarted(int,qint64)),this,SLOT(jobStarted(int,qint64)));
+        connect(worker,SIGNAL(jobProcessFinished(int,qint64)),this,SLOT(jobProcessFinished(int,qint64)));
+        connect(worker,SIGNAL(jobOutput(int,QString)),this,SLOT(jobOutput(int,QString)));
+        connect(worker,SIGNAL(jobProgress(int,FFProgress)),this,SLOT(jobProgress(int,FFProgress)));
+        connect(worker,SIGNAL(jobBenchmark(int,FFBenchmark)),this,SLOT(jobBenchmark(int,FFBenchmark)));
+        connect(worker,SIGNAL(jobError(int,QProcess::ProcessError)),this,SLOT(jobError(int,QProcess::ProcessError)));
+        connect(worker,SIGNAL(jobFinished(int,int)),this,SLOT(jobFinished(int,int)));
+        connect(worker,SIGNAL(debugInfo(QString)),this,SIGNAL(debugInfo(QString)));
+        thread->start();
+        _workers << worker;
+        _workerThreads << thread;
+        return worker;
+    }
+
+    //the least busy one
+    FFProcessWorker *worker = _workers[0];
+    int numJobs = _jobWorkers.keys(worker).count();
+    foreach(FFProcessWorker *w,_workers)
+    {
+        int n = _jobWorkers.keys(w).count();
+        if (n < numJobs)
+        {
+            worker = w;
+            numJobs = n;
+        }
+    }
+    return worker;
 }
 
 void FFmpeg::encodeNextItem()
 {
-    if (_encodingQueue.count() == 0)
+    qint64 traceStart = FFTrace::now();
+    int launched = 0;
+
+    while (_status == Encoding && _encodingQueue.count() > 0)
     {
-        setStatus(Waiting);
+        //each process of a sequence encoded by several processes counts as a running job
+        int freeProcesses = _maxRunningJobs - getRunningProcessesCount();
+        if (freeProcesses < 1) break;
+
+        FFQueueItem *item = _encodingQueue[0];
+        int processes = 1;
+        if (isBatchEncoding(item)) processes = std::min(_batchProcesses,freeProcesses);
+        //the estimation is for one process
+        qint64 estimate = _memoryEstimator->estimate(item);
+
+        //wait for the running items to finish if there's not enough memory, or use fewer processes.
+        //if nothing is running, launch anyway or the queue would be stuck
+        qint64 budget = getMemoryBudget();
+        if (budget > 0)
+        {
+            qint64 available = budget - getProjectedMemory();
+            qint64 fitting = 0;
+            if (available >= estimate) fitting = estimate > 0 ? available / estimate : processes;
+            if (_runningJobs.count() == 0) fitting = std::max(fitting,qint64(1));
+            if (fitting < 1)
+            {
+                emit debugInfo("Not enough memory to launch a new encoding, waiting for the running ones to finish.\nEstimated memory: " + QString::number(estimate/1024/1024) + " MB");
+                FFTrace::instant("memory wait","queue",0);
+                break;
+            }
+            processes = int(std::min(qint64(processes),fitting));
+        }
+
+        _encodingQueue.removeAt(0);
+        if (_queuedTimes.contains(item)) FFTrace::asyncSpan("wait","queue",qint64(quintptr(item)),_queuedTimes.take(item));
+        item->setEstimatedMemory(estimate * processes);
+        encodeItem(item,processes);
+        launched++;
+    }
+
+    if (_runningJobs.count() == 0 && _status == Encoding) setStatus(Waiting);
+
+    //read the next inputs while the running items encode
+    warmQueue();
+
+    QJsonObject traceArgs;
+    traceArgs.insert("launched",launched);
+    traceArgs.insert("queued",_encodingQueue.count());
+    traceArgs.insert("running",_runningJobs.count());
+    FFTrace::span("encodeNextItem","queue",0,traceStart,traceArgs);
+}
+
+void FFmpeg::encodeItem(FFQueueItem *item, int processes)
+{
+    _currentItem = item;
+
+    //register the job
+    _lastJobId++;
+    int id = _lastJobId;
+    _runningJobs.insert(id,item);
+    _jobWorkers.insert(id,getWorker());
+    _jobProcesses.insert(id,isBatchEncoding(item) ? processes : 1);
+    if (FFTrace::isEnabled())
+    {
+        _jobSlots.insert(id,traceSlot());
+        _jobPhaseStarts.insert(id,FFTrace::now());
+    }
+
+    item->resetStats();
+    item->output()->setCapacity(_outputBufferSize);
+    item->setStatus(FFQueueItem::InProgress);
+    item->setStartTime(QTime::currentTime());
+    emit  encodingStarted(item);
+    if (!_telemetryTimer->isActive()) _telemetryTimer->start();
+
+    //the mezzanines are identified by the state of all the frames, which are read in the background
+    QList<FFMediaInfo *> sequences = mezzanineSequences(item);
+    if (sequences.count() == 0)
+    {
+        launchJob(id);
         return;
     }
+    //the frames may have changed since the previous encoding
+    QList<QStringList> frames;
+    QStringList signatures;
+    foreach(FFMediaInfo *input,sequences)
+    {
+        frames << input->frameList();
+        signatures << mezzanineSignature(input);
+    }
+    QFutureWatcher<QStringList> *watcher = new QFutureWatcher<QStringList>(this);
+    connect(watcher,SIGNAL(finished()),this,SLOT(mezzanineKeysRead()));
+    _keyWatchers.insert(watcher,id);
+    watcher->setFuture(QtConcurrent::run(FFmpeg::readMezzanineKeys,frames,signatures));
+}
 
-    _currentItem = _encodingQueue.takeAt(0);
+void FFmpeg::mezzanineKeysRead()
+{
+    QFutureWatcher<QStringList> *watcher = static_cast<QFutureWatcher<QStringList> *>(sender());
+    int id = _keyWatchers.take(watcher);
+    QStringList keys = watcher->result();
+    watcher->deleteLater();
+    //the job has been stopped in the meantime
+    FFQueueItem *item = _runningJobs.value(id,nullptr);
+    if (item == nullptr) return;
+
+    QList<FFMediaInfo *> sequences = mezzanineSequences(item);
+    for (int i = 0 ; i < sequences.count() && i < keys.count() ; i++) sequences.at(i)->setMezzanineKey(keys.at(i));
+    launchJob(id);
+}
+
+void FFmpeg::launchJob(int id)
+{
+    FFQueueItem *item = _runningJobs.value(id);
+    FFProcessWorker *worker = _jobWorkers.value(id);
+    int processes = _jobProcesses.value(id);
 
     //generate arguments
-    QStringList arguments("-stats");
+    //machine readable stats on the standard output
+    QStringList arguments("-progress");
+    arguments << "pipe:1" << "-nostats";
     arguments << "-y";
 
+    //files to remove when the job ends
+    QStringList tempFiles;
+    //writes the frames of a followed sequence on stdin
+    FFFrameFeeder *feeder = nullptr;
+    //sequence to sequence: the frames are independent, they are converted by several processes
+    //sequence to movie by segments: only the segments with changed frames are encoded
+    bool segmented = isSegmentedEncoding(item);
+    bool batch = isBatchEncoding(item);
+    if (_benchmarkEnabled || item->isBenchmarkEnabled())
+    {
+        //the processes of a batch only print their errors
+        if (batch) emit debugInfo("Warning: profiling is not available when a sequence is encoded by several processes, this encoding won't be profiled.");
+        //process totals (user, system, real time and max memory), and time spent in each stage
+        else arguments << "-benchmark" << "-benchmark_all";
+    }
+    //the mezzanines to write along with the outputs, and the index of their input
+    QStringList mezzanines;
+    QList<int> mezzanineInputs;
+    //the mezzanines being written by the other jobs
+    QStringList writtenMezzanines;
+    foreach(QStringList jobMezzanines,_jobMezzanines) writtenMezzanines << jobMezzanines;
+    //the files actually read by the job, released from the cache when it ends
+    QStringList readFiles;
+
     //add inputs
-    foreach(FFMediaInfo *input,_currentItem->getInputMedias())
+    int inputIndex = -1;
+    foreach(FFMediaInfo *input,item->getInputMedias())
     {
+        inputIndex++;
         QString inputFileName = input->fileName();
+        //a sequence which has already been decoded is read from its mezzanine, its options have been applied
+        QString mezzanine = "";
+        if (!batch) mezzanine = mezzanineFileName(input);
+        if (mezzanine != "" && QFile::exists(mezzanine))
+        {
+            emit debugInfo("Reading " + input->fileName() + " from its mezzanine " + mezzanine);
+            arguments << "-i" << QDir::toNativeSeparators(mezzanine);
+            readFiles << mezzanine;
+            continue;
+        }
+        //the frames of a followed sequence are not written yet
+        if (input->isImageSequence() && !input->followSequence()) readFiles << input->frameList();
+        else if (!input->isImageSequence()) readFiles << inputFileName;
+        if (mezzanine != "" && !writtenMezzanines.contains(mezzanine) && !mezzanines.contains(mezzanine))
+        {
+            mezzanines << mezzanine;
+            mezzanineInputs << inputIndex;
+        }
         //add custom options
         foreach(QStringList option,input->ffmpegOptions())
         {
@@ -438,202 +1251,495 @@ void FFmpeg::encodeNextItem()
                 if (option[1] != "") arguments << option[1];
             }
         }
+        //a sequence still being rendered, or read in advance from a slow storage, is sent on stdin frame by frame; there is only one stdin
+        if (input->isImageSequence() && feeder == nullptr && !batch && (input->followSequence() || _prefetchThreads > 0))
+        {
+            feeder = new FFFrameFeeder();
+            if (input->followSequence())
+            {
+                feeder->setSequence(inputFileName,input->startNumber());
+                feeder->setCompletion(_followCompletion);
+                feeder->setTimeout(_followTimeout);
+            }
+            else
+            {
+                feeder->setFrames(input->frameList(),_prefetchThreads,_prefetchDepth);
+            }
+            arguments << "-f" << "image2pipe";
+            arguments << "-framerate" << QString::number(input->videoFramerate());
+            QString decoder = FFFrameFeeder::decoderName(QFileInfo(inputFileName).suffix());
+            if (decoder != "") arguments << "-c:v" << decoder;
+            arguments << "-i" << "pipe:0";
+            continue;
+        }
         //add sequence options
         if (input->isImageSequence())
         {
-            arguments << "-framerate" << QString::number(input->videoFramerate());
-            arguments << "-start_number" << QString::number(input->startNumber());
-            inputFileName = convertSequenceName(inputFileName);
+            QList<int> missing = input->missingFrames();
+            if (input->duplicateFrames().count() > 0)
+            {
+                emit debugInfo("Warning: " + QString::number(input->duplicateFrames().count()) + " frame numbers of " + input->fileName() + " are found in several files.");
+            }
+
+            bool sparse = false;
+            //the previous frame is held in the gaps, through a concat list
+            if (missing.count() > 0 && input->holdMissingFrames() && !batch)
+            {
+                QString listFileName = QDir::tempPath() + "/DuFFMpeg_" + QString::number(QCoreApplication::applicationPid()) + "_" + QString::number(id) + "_" + QString::number(tempFiles.count()) + ".ffconcat";
+                QFile listFile(listFileName);
+                if (listFile.open(QIODevice::WriteOnly))
+                {
+                    listFile.write(input->concatList().toUtf8());
+                    listFile.close();
+                    tempFiles << listFileName;
+                    arguments << "-f" << "concat" << "-safe" << "0";
+                    inputFileName = listFileName;
+                    sparse = true;
+                    emit debugInfo(QString::number(missing.count()) + " missing frames of " + input->fileName() + " replaced by the previous ones.");
+                }
+            }
+
+            if (!sparse)
+            {
+                if (missing.count() > 0 && !batch)
+                {
+                    emit debugInfo("Warning: " + QString::number(missing.count()) + " frames are missing in " + input->fileName() + ", the encoding will stop before frame " + QString::number(missing.first()) + ".");
+                }
+                arguments << "-framerate" << QString::number(input->videoFramerate());
+                arguments << "-start_number" << QString::number(input->startNumber());
+                inputFileName = convertSequenceName(inputFileName);
+            }
         }
         //add input file
         arguments << "-i" << QDir::toNativeSeparators(inputFileName);
     }
     //add outputs
-    foreach(FFMediaInfo *output,_currentItem->getOutputMedias())
+    foreach(FFMediaInfo *output,item->getOutputMedias()) arguments << outputArguments(output);
+    //the mezzanines are written while the sequences are decoded for the outputs
+    for (int i = 0 ; i < mezzanines.count() ; i++)
+    {
+        arguments << "-map" << QString::number(mezzanineInputs.at(i)) + ":v";
+        //intraframe, and slices decoded by several threads
+        arguments << "-c:v" << "ffv1" << "-level" << "3" << "-g" << "1" << "-slices" << "16" << "-slicecrc" << "0";
+        arguments << "-f" << "matroska" << QDir::toNativeSeparators(mezzanines.at(i) + ".part");
+    }
+
+    emit debugInfo("Beginning new encoding\nUsing FFmpeg commands:\n" + arguments.join(" | "));
+
+    //the feeder lives with the process
+    if (feeder != nullptr) feeder->moveToThread(worker->thread());
+    if (tempFiles.count() > 0) _jobTempFiles.insert(id,tempFiles);
+    if (mezzanines.count() > 0) _jobMezzanines.insert(id,mezzanines);
+    _jobInputFiles.insert(id,readFiles);
+
+    if (_jobLogsPath != "")
     {
-        //muxer
-        QString muxer = "";
-        if (output->muxer() != nullptr)
+        //one log file per encoding, named after the first output
+        QString baseName = "encoding";
+        if (item->getOutputMedias().count() > 0) baseName = QFileInfo(item->getOutputMedias()[0]->fileName()).completeBaseName();
+        QString logFileName = _jobLogsPath + "/" + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss") + "_" + QString::number(id) + "_" + baseName + ".log";
+        _jobLogFiles.insert(id,logFileName);
+        writeLog(logFileName,_ffmpeg->program() + " " + arguments.join(" ") + "\n");
+    }
+
+    QJsonObject event;
+    event.insert("event","start");
+    event.insert("job",id);
+    QJsonArray inputs;
+    foreach(FFMediaInfo *input,item->getInputMedias()) inputs.append(input->fileName());
+    event.insert("inputs",inputs);
+    QJsonArray outputs;
+    foreach(FFMediaInfo *output,item->getOutputMedias()) outputs.append(output->fileName());
+    event.insert("outputs",outputs);
+    event.insert("arguments",QJsonArray::fromStringList(arguments));
+    event.insert("estimatedMemory",item->estimatedMemory());
+    logEvent(event);
+
+    //launch, the process is created in the thread of the worker
+    if (batch)
+    {
+        FFBatch sequenceBatch = batchConversion(item,processes);
+        if (!segmented) emit debugInfo("Converting the sequence with " + QString::number(sequenceBatch.processes) + " processes, " + QString::number(sequenceBatch.chunkSize) + " frames each time");
+        QMetaObject::invokeMethod(worker,"startBatchJob",Qt::QueuedConnection,Q_ARG(int,id),Q_ARG(FFBatch,sequenceBatch));
+    }
+    else QMetaObject::invokeMethod(worker,"startJob",Qt::QueuedConnection,Q_ARG(int,id),Q_ARG(QString,_ffmpeg->program()),Q_ARG(QStringList,arguments),Q_ARG(FFFrameFeeder*,feeder));
+}
+
+bool FFmpeg::isSequenceConversion(FFQueueItem *item)
+{
+    if (item->getInputMedias().count() != 1 || item->getOutputMedias().count() != 1) return false;
+    FFMediaInfo *input = item->getInputMedias().first();
+    FFMediaInfo *output = item->getOutputMedias().first();
+    if (!input->isImageSequence() || input->followSequence()) return false;
+    if (output->muxer() == nullptr) return false;
+    return output->muxer()->isSequence();
+}
+
+bool FFmpeg::isBatchEncoding(FFQueueItem *item)
+{
+    if (isSegmentedEncoding(item)) return true;
+    return _batchProcesses > 1 && isSequenceConversion(item);
+}
+
+FFBatch FFmpeg::batchConversion(FFQueueItem *item, int processes)
+{
+    FFMediaInfo *input = item->getInputMedias().first();
+    FFMediaInfo *output = item->getOutputMedias().first();
+
+    FFBatch batch;
+    batch.program = _ffmpeg->program();
+
+    foreach(QStringList option,input->ffmpegOptions())
+    {
+        batch.inputArguments << option[0];
+        if (option.count() > 1)
         {
-            muxer = output->muxer()->name();
-            if (output->muxer()->isSequence()) muxer = "image2";
+            if (option[1] != "") batch.inputArguments << option[1];
         }
-        if (muxer != "")
+    }
+    batch.inputArguments << "-f" << "image2pipe";
+    batch.inputArguments << "-framerate" << QString::number(input->videoFramerate());
+    QString decoder = FFFrameFeeder::decoderName(QFileInfo(input->fileName()).suffix());
+    if (decoder != "") batch.inputArguments << "-c:v" << decoder;
+
+    //the start number is set for each chunk
+    batch.outputArguments = outputArguments(output);
+    batch.outputFileName = batch.outputArguments.takeLast();
+    int startNumberIndex = batch.outputArguments.indexOf("-start_number");
+    if (startNumberIndex >= 0 && startNumberIndex < batch.outputArguments.count() - 1)
+    {
+        batch.outputArguments.removeAt(startNumberIndex);
+        batch.outputArguments.removeAt(startNumberIndex);
+    }
+    batch.startNumber = output->startNumber();
+
+    batch.frames = input->frameList();
+    batch.processes = processes;
+    //a few chunks per process to balance the load, small enough to retry quickly
+    batch.chunkSize = qBound(1, batch.frames.count() / (processes * 4), 100);
+    //each segment is encoded by its own process, in a folder next to the output
+    if (isSegmentedEncoding(item))
+    {
+        batch.chunkSize = output->segmentLength();
+        QFileInfo outputInfo(batch.outputFileName);
+        batch.segmentsPath = outputInfo.path() + "/" + outputInfo.fileName() + ".segments";
+    }
+
+    return batch;
+}
+
+bool FFmpeg::isSegmentedEncoding(FFQueueItem *item)
+{
+    if (item->getInputMedias().count() != 1 || item->getOutputMedias().count() != 1) return false;
+    FFMediaInfo *input = item->getInputMedias().first();
+    FFMediaInfo *output = item->getOutputMedias().first();
+    if (!input->isImageSequence() || input->followSequence()) return false;
+    if (output->segmentLength() < 1 || !output->hasVideo()) return false;
+    if (output->muxer() == nullptr || output->muxer()->isSequence()) return false;
+    //a copied stream can't be cut at any frame
+    if (output->videoCodec() != nullptr && output->videoCodec()->name() == "copy") return false;
+    return true;
+}
+
+QList<FFMediaInfo *> FFmpeg::mezzanineSequences(FFQueueItem *item)
+{
+    QList<FFMediaInfo *> sequences;
+    //the processes of a batch read the frames
+    if (_mezzaninePath == "" || isBatchEncoding(item)) return sequences;
+    foreach(FFMediaInfo *input,item->getInputMedias())
+    {
+        //the frames of a followed sequence are not all written yet
+        if (input->isImageSequence() && !input->followSequence()) sequences << input;
+    }
+    return sequences;
+}
+
+QString FFmpeg::mezzanineSignature(FFMediaInfo *input)
+{
+    //the mezzanine depends on the frames and on how they are read
+    QStringList signature("ffv1");
+    foreach(QStringList option,input->ffmpegOptions()) signature << option;
+    signature << "-framerate" << QString::number(input->videoFramerate());
+    return signature.join(" ");
+}
+
+QStringList FFmpeg::readMezzanineKeys(QList<QStringList> frames, QStringList signatures)
+{
+    QStringList keys;
+    for (int i = 0 ; i < frames.count() ; i++) keys << FFFrameManifest::scan(frames.at(i),signatures.at(i),0).key();
+    return keys;
+}
+
+QString FFmpeg::mezzanineFileName(FFMediaInfo *input)
+{
+    if (_mezzaninePath == "" || input->mezzanineKey() == "") return "";
+    if (!input->isImageSequence() || input->followSequence()) return "";
+    return _mezzaninePath + "/" + input->mezzanineKey() + ".mkv";
+}
+
+QStringList FFmpeg::outputArguments(FFMediaInfo *output)
+{
+    QStringList arguments;
+
+    //muxer
+    QString muxer = "";
+    if (output->muxer() != nullptr)
+    {
+        muxer = output->muxer()->name();
+        if (output->muxer()->isSequence()) muxer = "image2";
+    }
+    if (muxer != "")
+    {
+        arguments << "-f" << muxer;
+    }
+
+    //add custom options
+    foreach(QStringList option,output->ffmpegOptions())
+    {
+        arguments << option[0];
+        if (option.count() > 1)
         {
-            arguments << "-f" << muxer;
+            if (option[1] != "") arguments << option[1];
         }
+    }
 
-        //add custom options
-        foreach(QStringList option,output->ffmpegOptions())
+    //video
+    QString codec = "";
+    if (output->videoCodec() != nullptr) codec = output->videoCodec()->name();
+
+
+    if (output->hasVideo())
+    {
+        //codec
+        if (codec != "") arguments << "-vcodec" << codec;
+
+        if (codec != "copy")
         {
-            arguments << option[0];
-            if (option.count() > 1)
+            //bitrate
+            int bitrate = output->videoBitrate();
+            if (bitrate != 0)
             {
-                if (option[1] != "") arguments << option[1];
-            }
-        }
+                arguments << "-b:v" << QString::number(bitrate);
 
-        //video
-        QString codec = "";
-        if (output->videoCodec() != nullptr) codec = output->videoCodec()->name();
+            }
 
+            //size
+            int width = output->videoWidth();
+            int height = output->videoHeight();
+            if (width != 0 && height != 0)
+            {
+                arguments << "-s" << QString::number(width) + "x" + QString::number(height);
+            }
 
-        if (output->hasVideo())
-        {
-            //codec
-            if (codec != "") arguments << "-vcodec" << codec;
+            //framerate
+            double framerate = output->videoFramerate();
+            if (framerate != 0.0)
+            {
+                arguments << "-r" << QString::number(framerate);
+            }
 
-            if (codec != "copy")
+            //loop (gif)
+            if (codec == "gif")
             {
-                //bitrate
-                int bitrate = output->videoBitrate();
-                if (bitrate != 0)
-                {
-                    arguments << "-b:v" << QString::number(bitrate);
+                int loop = output->loop();
+                arguments << "-loop" << QString::number(loop);
+            }
 
-                }
+            //profile
+            int profile = output->videoProfile();
+            if (profile > -1)
+            {
+                arguments << "-profile" << QString::number(profile);
+            }
 
-                //size
-                int width = output->videoWidth();
-                int height = output->videoHeight();
-                if (width != 0 && height != 0)
+            //quality (h264)
+            int quality = output->videoQuality();
+            if (codec == "h264" && quality > 0 )
+            {
+                quality = 100-quality;
+                //adjust to CRF values
+                if (quality < 10)
                 {
-                    arguments << "-s" << QString::number(width) + "x" + QString::number(height);
+                    //convert to range 0-15 // visually lossless
+                    quality = quality*15/10;
                 }
-
-                //framerate
-                double framerate = output->videoFramerate();
-                if (framerate != 0.0)
+                else if (quality < 25)
                 {
-                    arguments << "-r" << QString::number(framerate);
+                    //convert to range 15-21 // very good
+                    quality = quality-10;
+                    quality = quality*6/15;
+                    quality = quality+15;
                 }
-
-                //loop (gif)
-                if (codec == "gif")
+                else if (quality < 50)
                 {
-                    int loop = output->loop();
-                    arguments << "-loop" << QString::number(loop);
+                    //convert to range 22-28 // good
+                    quality = quality-25;
+                    quality = quality*6/25;
+                    quality = quality+21;
                 }
-
-                //profile
-                int profile = output->videoProfile();
-                if (profile > -1)
+                else if (quality < 75)
                 {
-                    arguments << "-profile" << QString::number(profile);
+                    //convert to range 29-34 // bad
+                    quality = quality-50;
+                    quality = quality*6/25;
+                    quality = quality+28;
                 }
-
-                //quality (h264)
-                int quality = output->videoQuality();
-                if (codec == "h264" && quality > 0 )
+                else
                 {
-                    quality = 100-quality;
-                    //adjust to CRF values
-                    if (quality < 10)
-                    {
-                        //convert to range 0-15 // visually lossless
-                        quality = quality*15/10;
-                    }
-                    else if (quality < 25)
-                    {
-                        //convert to range 15-21 // very good
-                        quality = quality-10;
-                        quality = quality*6/15;
-                        quality = quality+15;
-                    }
-                    else if (quality < 50)
-                    {
-                        //convert to range 22-28 // good
-                        quality = quality-25;
-                        quality = quality*6/25;
-                        quality = quality+21;
-                    }
-                    else if (quality < 75)
-                    {
-                        //convert to range 29-34 // bad
-                        quality = quality-50;
-                        quality = quality*6/25;
-                        quality = quality+28;
-                    }
-                    else
-                    {
-                        //convert to range 35-51 // very bad
-                        quality = quality-75;
-                        quality = quality*17/25;
-                        quality = quality+34;
-                    }
-                    arguments << "-crf" << QString::number(quality);
+                    //convert to range 35-51 // very bad
+                    quality = quality-75;
+                    quality = quality*17/25;
+                    quality = quality+34;
                 }
+                arguments << "-crf" << QString::number(quality);
+            }
 
-                //start number (sequences)
-                if (muxer == "image2")
-                {
-                    int startNumber = output->startNumber();
-                    arguments << "-start_number" << QString::number(startNumber);
-                }
+            //quality (jpeg)
+            if (codec == "mjpeg" && quality > 0)
+            {
+                //qscale from 31 (worst) to 2 (best)
+                int qscale = 31 - quality*29/100;
+                arguments << "-q:v" << QString::number(qscale);
             }
-        }
-        else
-        {
-            //no video
-            arguments << "-vn";
-        }
 
-        //audio
-        QString acodec = "";
-        if (output->audioCodec() != nullptr) acodec = output->audioCodec()->name();
+            //compression (png)
+            int compressionLevel = output->compressionLevel();
+            if (compressionLevel > -1)
+            {
+                arguments << "-compression_level" << QString::number(compressionLevel);
+            }
+            QString prediction = output->prediction();
+            if (prediction != "")
+            {
+                arguments << "-pred" << prediction;
+            }
 
-        if (output->hasAudio())
-        {
-            //codec
-            if (acodec != "") arguments << "-acodec" << acodec;
+            //compression (tiff)
+            QString compressionMethod = output->compressionMethod();
+            if (compressionMethod != "")
+            {
+                arguments << "-compression_algo" << compressionMethod;
+            }
 
-            if (acodec != "copy")
+            //pixel format (dpx packing)
+            QString pixelFormat = output->pixelFormat();
+            if (pixelFormat != "")
             {
-                //bitrate
-                int bitrate = output->audioBitrate();
-                if (bitrate != 0)
-                {
-                    arguments << "-b:a" << QString::number(output->audioBitrate());
-                }
+                arguments << "-pix_fmt" << pixelFormat;
+            }
 
-                //sampling
-                int sampling = output->audioSamplingRate();
-                if (sampling != 0)
-                {
-                    arguments << "-ar" << QString::number(sampling);
-                }
+            //start number (sequences)
+            if (muxer == "image2")
+            {
+                int startNumber = output->startNumber();
+                arguments << "-start_number" << QString::number(startNumber);
             }
         }
-        else
-        {
-            //no audio
-            arguments << "-an";
-        }
+    }
+    else
+    {
+        //no video
+        arguments << "-vn";
+    }
 
-        //file
-        QString outputPath = QDir::toNativeSeparators(output->fileName());
+    //audio
+    QString acodec = "";
+    if (output->audioCodec() != nullptr) acodec = output->audioCodec()->name();
 
-        //if sequence, digits
-        if (output->muxer() != nullptr)
+    if (output->hasAudio())
+    {
+        //codec
+        if (acodec != "") arguments << "-acodec" << acodec;
+
+        if (acodec != "copy")
         {
-            if (output->muxer()->isSequence())
+            //bitrate
+            int bitrate = output->audioBitrate();
+            if (bitrate != 0)
+            {
+                arguments << "-b:a" << QString::number(output->audioBitrate());
+            }
+
+            //sampling
+            int sampling = output->audioSamplingRate();
+            if (sampling != 0)
             {
-                outputPath = convertSequenceName(outputPath);
+                arguments << "-ar" << QString::number(sampling);
             }
         }
+    }
+    else
+    {
+        //no audio
+        arguments << "-an";
+    }
+
+    //file
+    QString outputPath = QDir::toNativeSeparators(output->fileName());
 
-        arguments << outputPath;
+    //if sequence, digits
+    if (output->muxer() != nullptr)
+    {
+        if (output->muxer()->isSequence())
+        {
+            outputPath = convertSequenceName(outputPath);
+        }
     }
 
-    emit debugInfo("Beginning new encoding\nUsing FFmpeg commands:\n" + arguments.join(" | "));
+    arguments << outputPath;
+
+    return arguments;
+}
+
+void FFmpeg::writeLog(QString fileName, QString text)
+{
+    QMetaObject::invokeMethod(_logWriter,"write",Qt::QueuedConnection,Q_ARG(QString,fileName),Q_ARG(QString,text));
+}
+
+void FFmpeg::logEvent(QJsonObject event)
+{
+    if (_jobLogsPath == "") return;
+    event.insert("time",QDateTime::currentDateTime().toString(Qt::ISODateWithMs));
+    writeLog(_jobLogsPath + "/events.jsonl",QJsonDocument(event).toJson(QJsonDocument::Compact) + "\n");
+}
 
-    //launch
-    _ffmpeg->setArguments(arguments);
-    _ffmpeg->start(QIODevice::ReadWrite);
+void FFmpeg::warmQueue()
+{
+    if (_cacheBudget <= 0 || _status != Encoding) return;
+    if (_encodingQueue.count() == 0) return;
+    //the head of the queue has not changed, its inputs are already in the cache
+    if (_encodingQueue.first() == _warmedItem) return;
+    _warmedItem = _encodingQueue.first();
+
+    //by order in the queue, the warmer stops at the budget
+    QStringList files;
+    foreach(FFQueueItem *item,_encodingQueue) files << inputFiles(item);
+    QMetaObject::invokeMethod(_cacheWarmer,"warm",Qt::QueuedConnection,Q_ARG(QStringList,files),Q_ARG(qint64,_cacheBudget));
+}
+
+QStringList FFmpeg::inputFiles(FFQueueItem *item)
+{
+    QStringList files;
+    foreach(FFMediaInfo *input,item->getInputMedias())
+    {
+        //the frames of a followed sequence are not written yet
+        if (input->followSequence()) continue;
+        //the key of an input which has not been encoded yet is unknown, its frames are read
+        QString mezzanine = mezzanineFileName(input);
+        if (mezzanine != "" && QFile::exists(mezzanine)) files << mezzanine;
+        else if (input->isImageSequence()) files << input->frameList();
+        else files << input->fileName();
+    }
+    return files;
+}
 
-    _currentItem->setStatus(FFQueueItem::InProgress);
-    _startTime = QTime::currentTime();
-    emit  encodingStarted(_currentItem);
+int FFmpeg::traceSlot()
+{
+    QList<int> usedSlots = _jobSlots.values();
+    int slot = 1;
+    while (usedSlots.contains(slot)) slot++;
+    FFTrace::setTrackName(slot,"Worker slot " + QString::number(slot));
+    return slot;
 }
 
 void FFmpeg::setStatus(Status st)
@@ -658,7 +1764,10 @@ void FFmpeg::gotMuxers(QString output)
 
     //get Muxers
     QStringList muxers = output.split("\n");
-    QRegularExpression re("[D. ]E (\\w+)\\s+(.+)");
+    const QRegularExpression &re = FFOutputParser::regExp(FFOutputParser::Muxer);
+    const QRegularExpression &reVideo = FFOutputParser::regExp(FFOutputParser::MuxerVideoCodec);
+    const QRegularExpression &reAudio = FFOutputParser::regExp(FFOutputParser::MuxerAudioCodec);
+    const QRegularExpression &reExtensions = FFOutputParser::regExp(FFOutputParser::MuxerExtensions);
 
     foreach(QString muxer,muxers)
     {
@@ -680,12 +1789,11 @@ void FFmpeg::gotMuxers(QString output)
             {
                 QStringList lines = _ffmpegOutput.split("\n");
 
-                QRegularExpression reVideo("Default video codec:\\s*(.+)\\.");
-                QRegularExpression reAudio("Default audio codec:\\s*(.+)\\.");
-                QRegularExpression reExtensions("Common extensions:\\s*(.+)\\.");
-
                 foreach(QString line,lines)
                 {
+                    //the muxer infos are on lines starting with a space
+                    if (!line.startsWith(" ")) continue;
+
                     //video codec
                     QRegularExpressionMatch videoMatch = reVideo.match(line);
                     if (videoMatch.hasMatch())
@@ -850,7 +1958,7 @@ void FFmpeg::gotCodecs(QString output)
 
     //get codecs
     QStringList codecs = output.split("\n");
-    QRegularExpression re("([D.])([E.])([VAS])([I.])([L.])([S.]) (\\w+) +([^\\(\\n]+)");
+    const QRegularExpression &re = FFOutputParser::regExp(FFOutputParser::Codec);
     for (int i = 0 ; i < codecs.count() ; i++)
     {
         QString codec = codecs[i];
@@ -885,63 +1993,13 @@ void FFmpeg::readyRead(QString output)
 {
     emit newOutput(output);
 
-    _ffmpegOutput = _ffmpegOutput + output;
-
-    QRegularExpression reProgress("(?:frame= *(\\d+).*fps= *(\\d+).*)?size= *(?:(\\d+)kB)?.*time=(\\d\\d:\\d\\d:\\d\\d.\\d\\d).*bitrate= *(?:(\\d+).\\d+kbits)?.*speed= *(\\d+.\\d*)x");
-    QRegularExpressionMatch match = reProgress.match(output);
-    //if progress, update UI
-    if (match.hasMatch())
-    {
-        QString frame = match.captured(1);
-        QString size = match.captured(3);
-        QString bitrate = match.captured(5);
-        QString speed = match.captured(6);
-
-        //frame
-        _currentFrame = frame.toInt();
-
-        //size
-        int sizeKB = size.toInt();
-        _outputSize = sizeKB*1024;
-
-        //bitrate
-        int bitrateKB = bitrate.toInt();
-        _outputBitrate = bitrateKB*1024;
-
-        //speed
-        _encodingSpeed = speed.toDouble();
-
-        //time remaining
-        //get current input duration
-        //gets the current item duration
-        int duration = 0;
-        foreach(FFMediaInfo *input,_currentItem->getInputMedias())
-        {
-            if (input->hasVideo())
-            {
-                duration = input->duration() * input->videoFramerate();
-                break;
-            }
-        }
-        if (duration > 0)
-        {
-            if (_currentFrame > 0)
-            {
-                int elapsed = _startTime.elapsed() / 1000;
-                int remaining = elapsed*duration/_currentFrame - elapsed;
-                _timeRemaining = QTime(0,0,0).addSecs(remaining);
-            }
-        }
-        emit progress();
-    }
-
+    _ffmpegOutput.append(output);
 }
 
 QString FFmpeg::convertSequenceName(QString name)
 {
     //detects all {###}
-    QRegularExpression regExDigits("{(#+)}");
-    QRegularExpressionMatchIterator regExDigitsMatch = regExDigits.globalMatch(name);
+    QRegularExpressionMatchIterator regExDigitsMatch = FFOutputParser::regExp(FFOutputParser::SequenceDigits).globalMatch(name);
     while (regExDigitsMatch.hasNext())
     {
          QRegularExpressionMatch match = regExDigitsMatch.next();
@@ -1010,6 +2068,11 @@ FFMediaInfo *FFmpeg::loadJson(QString json)
         mediaInfo->setVideoProfile(videoObj.value("profile").toInt());
         mediaInfo->setVideoQuality(videoObj.value("quality").toInt());
         mediaInfo->setStartNumber(videoObj.value("startNumber").toInt());
+        mediaInfo->setSegmentLength(videoObj.value("segmentLength").toInt());
+        mediaInfo->setCompressionLevel(videoObj.value("compressionLevel").toInt(-1));
+        mediaInfo->setPrediction(videoObj.value("prediction").toString());
+        mediaInfo->setCompressionMethod(videoObj.value("compressionMethod").toString());
+        mediaInfo->setPixelFormat(videoObj.value("pixelFormat").toString());
     }
 
     //audio
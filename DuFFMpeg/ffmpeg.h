@@ -5,13 +5,33 @@
 
 #include <QProcess>
 #include <QTime>
+#include <QDateTime>
+#include <QTimer>
+#include <QThread>
 #include <QDir>
+#include <QCoreApplication>
+#include <QMap>
+#include <QSet>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 #include <algorithm>
 
 #include "ffcodec.h"
 #include "ffmediainfo.h"
 #include "ffqueueitem.h"
 #include "ffmuxer.h"
+#include "ffmemoryestimator.h"
+#include "ffprocessworker.h"
+#include "ffframefeeder.h"
+#include "fflogwriter.h"
+#include "ffcachewarmer.h"
+#include "ffframemanifest.h"
+#include "ffprocessmonitor.h"
+#include "ffmetricsexporter.h"
+#include "fftrace.h"
 
 class FFmpeg : public FFObject
 {
@@ -23,6 +43,7 @@ public:
      * @param parent The parent QObject
      */
     explicit FFmpeg(QString path, QObject *parent = nullptr);
+    ~FFmpeg();
 
     /**
      * @brief The Status enum Used to describe the current status of ffmpeg
@@ -63,6 +84,7 @@ public:
     FFCodec *getAudioEncoder(QString name);
     /**
      * @brief getHelp Gets the help text of FFmpeg
+     * It is loaded from FFmpeg the first time it is needed
      * @return The documentation
      */
     QString getHelp();
@@ -71,6 +93,10 @@ public:
      * @return The longer version of the documentation
      */
     QString getLongHelp();
+    /**
+     * @brief loadLongHelp Loads the longer help of FFmpeg in the background, longHelpLoaded is emitted when it's ready
+     */
+    void loadLongHelp();
     /**
      * @brief getMediaInfo Gets the information for the media
      * @param mediaPath The path to the media file
@@ -122,9 +148,50 @@ public:
     QTime getTimeRemaining();
     /**
      * @brief getCurrentInputInfos Gets the item currently being encoded
+     * When several items are encoded at the same time, this is the latest one which has been launched
      * @return The queue item
      */
     FFQueueItem *getCurrentItem();
+    /**
+     * @brief getRunningItems Gets all the items currently being encoded
+     * @return The queue items
+     */
+    QList<FFQueueItem *> getRunningItems();
+    /**
+     * @brief getMaxRunningJobs Gets the maximum number of FFmpeg processes which can encode at the same time
+     * @return The number of processes
+     */
+    int getMaxRunningJobs();
+    /**
+     * @brief getRunningProcessesCount Gets the number of FFmpeg processes the running items may use at the same time.
+     * A sequence encoded by several processes counts for each of them
+     * @return The number of processes
+     */
+    int getRunningProcessesCount();
+    /**
+     * @brief getMemoryBudget Gets the memory the running FFmpeg processes are allowed to use
+     * If no budget has been set, this is 80% of the physical memory
+     * @return The memory in bytes, or 0 if there is no limit
+     */
+    qint64 getMemoryBudget();
+    /**
+     * @brief getProjectedMemory Gets the memory the running FFmpeg processes are expected to use at their peak
+     * @return The memory in bytes
+     */
+    qint64 getProjectedMemory();
+    /**
+     * @brief getQueueLength Gets the number of items waiting in the queue
+     */
+    int getQueueLength();
+    /**
+     * @brief getFinishedJobsCount Gets the number of encodings which have exited successfully
+     */
+    int getFinishedJobsCount();
+    /**
+     * @brief getFailedJobsCount Gets the number of encodings which have exited with an error or crashed
+     * The encodings stopped by the user are not counted
+     */
+    int getFailedJobsCount();
     /**
      * @brief getLastError Gets the last error that occured
      * @return The error
@@ -189,18 +256,24 @@ public:
      */
     void clearQueue();
     /**
-     * @brief stop Stops the current FFmpeg process
-     * @param timeout Kills the process after timeout if it does not respond. In milliseconds.
+     * @brief stop Stops all the running FFmpeg processes, without waiting for them.
+     * The processes are first asked to quit, then terminated (SIGTERM) and finally killed (SIGKILL) if they do not respond.
+     * The stopped signal is emitted when all of them have finished.
+     * @param timeout The delay before each escalation. In milliseconds.
      */
-    void stop(int timeout = 10000);
+    void stop(int timeout = 5000);
     FFMediaInfo *loadJson(QString json);
     FFMediaInfo *loadJsonFromFile(QString jsonFileName);
 
 signals:
     /**
-     * @brief newOutput Emitteed when FFmpeg outputs on stderr or stdoutput
+     * @brief newOutput Emitteed when FFmpeg outputs on stderr or stdoutput, when running commands
      */
     void newOutput(QString);
+    /**
+     * @brief newJobOutput Emitted when an encoding process outputs on stderr, by complete lines
+     */
+    void newJobOutput(FFQueueItem*,QString);
     /**
      * @brief encodingStarted Emitted when FFmpeg starts an encoding process, with infos about the input media
      */
@@ -210,9 +283,18 @@ signals:
      */
     void encodingFinished(FFQueueItem*);
     /**
-     * @brief progress Emitted each time the transcoding process outputs new stats
+     * @brief stopped Emitted when all the processes being stopped have finished
+     */
+    void stopped();
+    /**
+     * @brief progress Emitted when the running processes have output new stats
+     * The updates of all the processes are merged, the signal is emitted at most at the progress rate
      */
     void progress();
+    /**
+     * @brief telemetry Emitted when the resources used by the running processes have been sampled, every second
+     */
+    void telemetry();
     /**
      * @brief error Emitted when an error occured with the FFmpeg process
      * Emits a human readable string
@@ -226,6 +308,10 @@ signals:
      * @brief binaryChanged Emitted when the path to the binary has been changed
      */
     void binaryChanged();
+    /**
+     * @brief longHelpLoaded Emitted when the longer help has been loaded by loadLongHelp
+     */
+    void longHelpLoaded(QString);
     /**
      * @brief debugInfo Regularly sends useful informations for debugging
      * @param log
@@ -250,8 +336,90 @@ public slots:
      */
     void runCommand(QStringList commands);
     void init();
+    /**
+     * @brief setMaxRunningJobs Sets the maximum number of FFmpeg processes which can encode at the same time
+     * @param maxRunningJobs The number of processes
+     */
+    void setMaxRunningJobs(int maxRunningJobs);
+    /**
+     * @brief setMemoryBudget Sets the memory the running FFmpeg processes are allowed to use.
+     * New items are not launched while the projected memory of the running processes would exceed the budget.
+     * @param memoryBudget The memory in bytes, 0 to use 80% of the physical memory, -1 for no limit
+     */
+    void setMemoryBudget(qint64 memoryBudget);
+    /**
+     * @brief setOutputBufferSize Sets the size of the buffer keeping the latest output of each encoding
+     * @param size The number of characters kept
+     */
+    void setOutputBufferSize(int size);
+    /**
+     * @brief setJobLogsPath Sets the folder where the complete output of each encoding is written,
+     * with the events.jsonl log of the encodings (start, finish, arguments, exit code, stats)
+     * @param path The folder, an empty string to disable the log files
+     */
+    void setJobLogsPath(QString path);
+    /**
+     * @brief setLogsMaxSize Sets the size at which the log files are rotated
+     * @param size The size in bytes, 0 to never rotate
+     */
+    void setLogsMaxSize(qint64 size);
+    /**
+     * @brief setProgressRate Sets how many times per second the progress signal can be emitted
+     * @param rate The number of updates per second
+     */
+    void setProgressRate(int rate);
+    /**
+     * @brief setMetricsPort Starts or stops the local server exporting the metrics in the Prometheus format
+     * @param port The port, 0 to disable the server
+     */
+    void setMetricsPort(int port);
+    /**
+     * @brief setBenchmarkEnabled Profiles all the encodings: FFmpeg reports the time spent in each stage (-benchmark and -benchmark_all)
+     * The items can also be profiled one by one with FFQueueItem::setBenchmarkEnabled, with the Profile button of the main window
+     */
+    void setBenchmarkEnabled(bool enabled);
+    /**
+     * @brief setFollowCompletion Sets how to know that a frame of a followed sequence is complete
+     * @param completion A FFFrameFeeder::Completion
+     */
+    void setFollowCompletion(int completion);
+    /**
+     * @brief setFollowTimeout Sets the delay without a new frame after which a followed sequence is finished
+     * @param timeout The delay in seconds
+     */
+    void setFollowTimeout(int timeout);
+    /**
+     * @brief setPrefetchThreads Sets the number of threads reading the frames of the sequences in advance
+     * @param threads The number of threads, 0 to let FFmpeg read the files itself
+     */
+    void setPrefetchThreads(int threads);
+    /**
+     * @brief setPrefetchDepth Sets the number of frames read in advance
+     */
+    void setPrefetchDepth(int depth);
+    /**
+     * @brief setCacheBudget Sets the amount of the next inputs of the queue loaded in the page cache in advance
+     * @param budget The size in bytes, 0 to disable the cache warming
+     */
+    void setCacheBudget(qint64 budget);
+    /**
+     * @brief setBatchProcesses Sets the number of processes converting an image sequence to another image sequence
+     * @param processes The number of processes, 1 to convert the sequence with a single FFmpeg process
+     */
+    void setBatchProcesses(int processes);
+    /**
+     * @brief setMezzaninePath Sets the folder of the mezzanine cache.
+     * The first time an image sequence is encoded, an FFV1 intraframe copy is written along with the outputs,
+     * and the next encodings of the same frames read this copy instead of decoding the images again.
+     * @param path The folder, an empty string to disable the cache
+     */
+    void setMezzaninePath(QString path);
 
 private slots:
+    /**
+     * @brief longHelpFinished Reads the help when the process started by loadLongHelp has finished
+     */
+    void longHelpFinished();
     //FFmpeg signals
     void stdError();
     void stdOutput();
@@ -259,7 +427,31 @@ private slots:
     void finished();
     void errorOccurred(QProcess::ProcessError e);
 
+    //Encoding processes signals, from the workers
+    void jobStarted(int id, qint64 pid);
+    void jobProcessFinished(int id, qint64 pid);
+    void jobOutput(int id, QString output);
+    void jobProgress(int id, FFProgress stats);
+    void jobBenchmark(int id, FFBenchmark benchmark);
+    void jobError(int id, QProcess::ProcessError e);
+    void jobFinished(int id, int exitCode);
+    /**
+     * @brief sampleProcesses Reads the resources (CPU, memory, I/O) used by the running FFmpeg processes
+     */
+    void sampleProcesses();
+    /**
+     * @brief mezzanineKeysRead Sets the keys of the mezzanines read in the background, and launches the job
+     */
+    void mezzanineKeysRead();
+    /**
+     * @brief emitProgress Emits the progress signal if new stats have been received since the latest one
+     */
+    void emitProgress();
+
     //Queue
+    /**
+     * @brief encodeNextItem Launches the next items in the queue, as long as the number of jobs and the memory budget allow it
+     */
     void encodeNextItem();
 
     //self
@@ -269,6 +461,7 @@ private:
     //=== About FFmpeg ===
     /**
      * @brief ffmpeg The process used to handle the binary
+     * Used to get infos and run commands, the encoding is done by the processes of the workers
      */
     QProcess *_ffmpeg;
     /**
@@ -291,7 +484,12 @@ private:
      */
     QString _longHelp;
     /**
-     * @brief ffmpegOutput The complete output of the latest ffmpeg process until it has finished
+     * @brief _helpProcess The process loading the longer help, nullptr when it's not loading
+     */
+    QProcess *_helpProcess;
+    /**
+     * @brief ffmpegOutput The complete output of the latest ffmpeg command until it has finished
+     * The outputs of the encodings are kept by their queue items
      */
     QString _ffmpegOutput;
     /**
@@ -306,13 +504,6 @@ private:
      * @brief lastErrorMessage The human readable description of the last error
      */
     QString _lastErrorMessage;
-    //=== Current Encoding ===
-    int _currentFrame;
-    QTime _startTime;
-    double _outputSize;
-    int _outputBitrate;
-    double _encodingSpeed;
-    QTime _timeRemaining;
     //=== Queue ===
     /**
      * @brief encodingQueue The queue of items to be encoded
@@ -323,9 +514,247 @@ private:
      */
     QList<FFQueueItem *> _encodingHistory;
     /**
-     * @brief currentItem The item currently being encoded
+     * @brief currentItem The latest item which has been launched
      */
     FFQueueItem *_currentItem;
+    /**
+     * @brief runningJobs The ids of the jobs currently encoding, and their item
+     */
+    QMap<int, FFQueueItem *> _runningJobs;
+    /**
+     * @brief jobProcessIds The ids of the running processes of each job, once they have started
+     */
+    QMap<int, QList<qint64> > _jobProcessIds;
+    /**
+     * @brief jobProcesses The number of processes each job may run at the same time
+     */
+    QMap<int, int> _jobProcesses;
+    /**
+     * @brief processSamples The latest sample of each running process
+     */
+    QMap<qint64, FFProcessSample> _processSamples;
+    /**
+     * @brief jobEndedSamples The CPU time, I/O and context switches of the processes of each job which have finished
+     */
+    QMap<int, FFProcessSample> _jobEndedSamples;
+    /**
+     * @brief jobProcessPeaks The highest memory used by one of the processes of each job
+     */
+    QMap<int, qint64> _jobProcessPeaks;
+    /**
+     * @brief jobWorkers The worker running each job
+     */
+    QMap<int, FFProcessWorker *> _jobWorkers;
+    /**
+     * @brief stoppingJobs The jobs which have been asked to stop
+     */
+    QList<int> _stoppingJobs;
+    /**
+     * @brief lastJobId The id given to the latest job
+     */
+    int _lastJobId;
+    int _finishedJobs;
+    int _failedJobs;
+    //=== Trace ===
+    /**
+     * @brief jobSlots The worker slot (the track in the trace) of each running job, from 1 to the maximum number of jobs
+     */
+    QMap<int, int> _jobSlots;
+    /**
+     * @brief jobPhaseStarts The time the current phase (spawn, encode) of each running job has started, in the trace
+     */
+    QMap<int, qint64> _jobPhaseStarts;
+    /**
+     * @brief queuedTimes The time the items have started waiting in the queue, in the trace
+     */
+    QMap<FFQueueItem *, qint64> _queuedTimes;
+    /**
+     * @brief workers The workers running the encoding processes and draining their pipes, each one in its own thread
+     */
+    QList<FFProcessWorker *> _workers;
+    QList<QThread *> _workerThreads;
+    /**
+     * @brief maxRunningJobs The maximum number of FFmpeg processes which can encode at the same time
+     */
+    int _maxRunningJobs;
+    /**
+     * @brief memoryBudget The memory the running processes are allowed to use. 0 for auto, -1 for no limit.
+     */
+    qint64 _memoryBudget;
+    /**
+     * @brief outputBufferSize The number of characters of output kept for each encoding
+     */
+    int _outputBufferSize;
+    /**
+     * @brief benchmarkEnabled True to profile all the encodings
+     */
+    bool _benchmarkEnabled;
+    /**
+     * @brief followCompletion How the frames of the followed sequences are known to be complete
+     */
+    FFFrameFeeder::Completion _followCompletion;
+    int _followTimeout;
+    /**
+     * @brief prefetchThreads The number of threads reading the frames of the sequences in advance, 0 if disabled
+     */
+    int _prefetchThreads;
+    int _prefetchDepth;
+    /**
+     * @brief batchProcesses The number of processes converting the frames of a sequence to another sequence
+     */
+    int _batchProcesses;
+    QString _mezzaninePath;
+    /**
+     * @brief jobLogsPath The folder where the log files of the encodings are written, empty if disabled
+     */
+    QString _jobLogsPath;
+    /**
+     * @brief jobLogFiles The log file of each running job
+     */
+    QMap<int, QString> _jobLogFiles;
+    /**
+     * @brief jobTempFiles The files generated for each running job (concat lists), removed when it ends
+     */
+    QMap<int, QStringList> _jobTempFiles;
+    /**
+     * @brief _jobMezzanines The mezzanines written by each running job, renamed from .part when it succeeds
+     */
+    QMap<int, QStringList> _jobMezzanines;
+    /**
+     * @brief _jobInputFiles The files read by each running job, released from the page cache when it ends
+     */
+    QMap<int, QStringList> _jobInputFiles;
+    /**
+     * @brief logWriter Writes the logs in its own thread
+     */
+    FFLogWriter *_logWriter;
+    QThread *_logThread;
+    /**
+     * @brief cacheWarmer Loads the next inputs in the page cache, in its own thread
+     */
+    FFCacheWarmer *_cacheWarmer;
+    QThread *_cacheThread;
+    /**
+     * @brief cacheBudget The number of bytes of the next inputs loaded in advance, 0 if disabled
+     */
+    qint64 _cacheBudget;
+    /**
+     * @brief warmedItem The first item of the queue when the cache was last warmed
+     */
+    FFQueueItem *_warmedItem;
+    /**
+     * @brief warmQueue Loads the inputs of the next items in the page cache, if the queue has changed
+     */
+    void warmQueue();
+    /**
+     * @brief inputFiles The files read by an item: the files of the inputs, or the frames of the sequences
+     */
+    QStringList inputFiles(FFQueueItem *item);
+    /**
+     * @brief memoryEstimator Estimates the memory needed by each item before launching it
+     */
+    FFMemoryEstimator *_memoryEstimator;
+    /**
+     * @brief telemetryTimer Samples the resources used by the running processes
+     */
+    QTimer *_telemetryTimer;
+    /**
+     * @brief metricsExporter Serves the metrics to Prometheus
+     */
+    FFMetricsExporter *_metricsExporter;
+    /**
+     * @brief progressTimer Limits the rate of the progress signal
+     */
+    QTimer *_progressTimer;
+    /**
+     * @brief progressPending True when stats have been received and not sent yet
+     */
+    bool _progressPending;
+    /**
+     * @brief encodeItem Registers a new job to encode the item, and launches it once the keys of its mezzanines have been read
+     * @param item The item to encode
+     * @param processes The number of processes a sequence encoded by several processes can use
+     */
+    void encodeItem(FFQueueItem *item, int processes = 1);
+    /**
+     * @brief launchJob Builds the arguments and launches the FFmpeg processes of a registered job
+     * @param id The job id
+     */
+    void launchJob(int id);
+    /**
+     * @brief keyWatchers The jobs reading the state of their frames to identify their mezzanines, before being launched
+     */
+    QMap<QFutureWatcher<QStringList> *, int> _keyWatchers;
+    /**
+     * @brief outputArguments Builds the arguments of an output
+     * @return The arguments, the last one is the file name
+     */
+    QStringList outputArguments(FFMediaInfo *output);
+    /**
+     * @brief isSequenceConversion Checks if an item converts an image sequence to another image sequence, which can be split by frames
+     */
+    bool isSequenceConversion(FFQueueItem *item);
+    /**
+     * @brief isBatchEncoding Checks if an item is encoded by several processes, split by frames
+     */
+    bool isBatchEncoding(FFQueueItem *item);
+    /**
+     * @brief batchConversion Builds the conversion of an image sequence by several processes
+     * @param processes The number of processes running at the same time
+     */
+    FFBatch batchConversion(FFQueueItem *item, int processes);
+    /**
+     * @brief sampleJob Reads the resources used by all the processes of a job, and sets them to its item
+     */
+    void sampleJob(int id);
+    /**
+     * @brief isSegmentedEncoding Checks if an item encodes an image sequence to a movie by segments
+     */
+    bool isSegmentedEncoding(FFQueueItem *item);
+    /**
+     * @brief mezzanineSequences The inputs of an item which can be read from a mezzanine, and need their key
+     */
+    QList<FFMediaInfo *> mezzanineSequences(FFQueueItem *item);
+    /**
+     * @brief mezzanineSignature How the frames of an input are read, part of the key of its mezzanine
+     */
+    QString mezzanineSignature(FFMediaInfo *input);
+    /**
+     * @brief readMezzanineKeys Reads the state of all the frames of the inputs to identify their mezzanines in the cache.
+     * It has to stat all the frames, it is run in the background when the inputs are encoded
+     * @return The keys, in the order of the inputs
+     */
+    static QStringList readMezzanineKeys(QList<QStringList> frames, QStringList signatures);
+    /**
+     * @brief mezzanineFileName The path of the mezzanine of an input in the cache, which may not exist yet
+     * @return An empty string if the cache is disabled, the input can't be cached or its key has not been computed yet
+     */
+    QString mezzanineFileName(FFMediaInfo *input);
+    /**
+     * @brief getWorker Gets the worker which will run the next job
+     * One worker thread is created for every four simultaneous encodings, the least busy one is used
+     * @return The worker
+     */
+    FFProcessWorker *getWorker();
+    /**
+     * @brief endJob Removes a job which has finished, and moves its item to the history
+     * @param id The job id
+     * @param exitCode The exit code of the process
+     */
+    void endJob(int id, int exitCode);
+    /**
+     * @brief writeLog Sends text to the log writer, without waiting
+     */
+    void writeLog(QString fileName, QString text);
+    /**
+     * @brief logEvent Adds an event to the events.jsonl log, if the logs are enabled
+     * @param event The event, the time is added
+     */
+    void logEvent(QJsonObject event);
+    /**
+     * @brief traceSlot Gets the free worker slot with the lowest number, to show the job on its track in the trace
+     */
+    int traceSlot();
     //=== Process outputs ===
     /**
      * @brief ffmpeg_gotCodecs Parses the muxers list
@@ -343,6 +772,12 @@ private:
      */
     void readyRead(QString output);
     //=== Misc. ===
+    /**
+     * @brief processErrorString Gets a human readable description of a process error
+     * @param e The error
+     * @return The description
+     */
+    QString processErrorString(QProcess::ProcessError e);
     /**
      * @brief convertSequenceName Converts a filename with {####} to ffmpeg %4d
      * @param name
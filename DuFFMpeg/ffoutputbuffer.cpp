@@ -0,0 +1,71 @@
+#include "ffoutputbuffer.h"
+
+#include <algorithm>
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFOutputBuffer::FFOutputBuffer(int capacity, QObject *parent) : FFObject(parent)
+{
+    setCapacity(capacity);
+}
+
+void FFOutputBuffer::append(const QString &output)
+{
+    if (_capacity == 0) return;
+
+    //only the end is kept if the output is longer than the buffer
+    const QChar *source = output.constData();
+    int count = output.size();
+    if (count > _capacity)
+    {
+        source += count - _capacity;
+        count = _capacity;
+    }
+
+    //the buffer grows with the output until it reaches its capacity
+    if (_buffer.size() < _capacity)
+    {
+        int room = _capacity - _buffer.size();
+        _buffer.append(source, qMin(count, room));
+        if (count <= room) return;
+        source += room;
+        count -= room;
+        _end = 0;
+    }
+
+    //full: copy until the end of the buffer, then wrap
+    QChar *data = _buffer.data();
+    int first = qMin(count, _capacity - _end);
+    std::copy(source, source + first, data + _end);
+    std::copy(source + first, source + count, data);
+
+    _end = (_end + count) % _capacity;
+}
+
+QString FFOutputBuffer::text() const
+{
+    if (_buffer.size() < _capacity) return _buffer;
+    //full: the oldest character is at the write position
+    return _buffer.mid(_end) + _buffer.left(_end);
+}
+
+void FFOutputBuffer::clear()
+{
+    //releases the memory
+    _buffer.clear();
+    _end = 0;
+}
+
+int FFOutputBuffer::capacity() const
+{
+    return _capacity;
+}
+
+void FFOutputBuffer::setCapacity(int capacity)
+{
+    if (capacity < 0) capacity = 0;
+    _capacity = capacity;
+    clear();
+}
@@ -0,0 +1,51 @@
+#ifndef FFOUTPUTBUFFER_H
+#define FFOUTPUTBUFFER_H
+
+#include "ffobject.h"
+
+/**
+ * @brief The FFOutputBuffer class Keeps the latest output of an FFmpeg process in a fixed-capacity ring buffer.
+ * The memory used does not depend on the length of the encoding: the buffer grows with the output up to its capacity,
+ * then the oldest output is overwritten.
+ * The complete output can be written to a log file by FFLogWriter.
+ */
+class FFOutputBuffer : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFOutputBuffer(int capacity = 1024*1024, QObject *parent = nullptr);
+
+    /**
+     * @brief append Adds output at the end of the buffer, overwriting the oldest output if it is full
+     * @param output The output
+     */
+    void append(const QString &output);
+    /**
+     * @brief text Gets the output kept in the buffer
+     * @return The latest output, at most capacity() characters
+     */
+    QString text() const;
+    /**
+     * @brief clear Empties the buffer and releases its memory
+     */
+    void clear();
+    /**
+     * @brief capacity The maximum number of characters kept in the buffer
+     */
+    int capacity() const;
+    /**
+     * @brief setCapacity Changes the capacity of the buffer. The buffer is cleared.
+     * @param capacity The number of characters
+     */
+    void setCapacity(int capacity);
+
+private:
+    QString _buffer;
+    int _capacity;
+    /**
+     * @brief _end The position where the next character will be written, once the buffer is full
+     */
+    int _end;
+};
+
+#endif // FFOUTPUTBUFFER_H
@@ -0,0 +1,201 @@
+#include "ffoutputparser.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFOutputParser::FFOutputParser(QObject *parent) : FFObject(parent)
+{
+
+}
+
+const QRegularExpression &FFOutputParser::regExp(Pattern pattern)
+{
+    //compiled the first time they are used
+    static const QVector<QRegularExpression> regExps = compileRegExps();
+    return regExps.at(pattern);
+}
+
+QStringList FFOutputParser::addData(const QString &data)
+{
+    QStringList lines;
+
+    int start = 0;
+    int end = data.indexOf('\n');
+    while (end >= 0)
+    {
+        QString line = data.mid(start,end-start);
+        //the beginning of the line was in the previous chunks
+        if (start == 0 && _pending != "")
+        {
+            line = _pending + line;
+            _pending.clear();
+        }
+        if (line.endsWith('\r')) line.chop(1);
+        lines << line;
+        start = end + 1;
+        end = data.indexOf('\n',start);
+    }
+    _pending.append(data.midRef(start));
+
+    return lines;
+}
+
+QString FFOutputParser::flush()
+{
+    QString remaining = _pending;
+    _pending.clear();
+    return remaining;
+}
+
+int FFOutputParser::benchmark(QString fileName)
+{
+    QTextStream out(stdout);
+
+    QFile recordFile(fileName);
+    if (!recordFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        out << "Cannot read " << fileName << "\n";
+        out.flush();
+        return 1;
+    }
+    QString record = QString::fromUtf8(recordFile.readAll());
+    recordFile.close();
+
+    QList<Pattern> patterns;
+    patterns << Input << Duration << VideoStream << AudioStream << Muxer << Codec;
+
+    QList<int> volumes;
+    volumes << 1 << 100;
+    foreach(int volume,volumes)
+    {
+        QString output = record.repeated(volume);
+        out << "=== " << fileName << " x" << volume << " (" << output.count() << " characters)" << "\n";
+
+        QElapsedTimer timer;
+
+        //lines, from chunks of the size read from a pipe
+        timer.start();
+        FFOutputParser parser;
+        QStringList lines;
+        for (int i = 0 ; i < output.count() ; i += 4096)
+        {
+            lines.append(parser.addData(output.mid(i,4096)));
+        }
+        QString last = parser.flush();
+        if (last != "") lines << last;
+        qint64 splitTime = timer.nsecsElapsed();
+        out << "Line splitting: " << lines.count() << " lines, " << splitTime/1000 << " us" << "\n";
+
+        //media infos, the lines are filtered before the patterns as in FFMediaInfo::updateInfo
+        timer.restart();
+        int matches = 0;
+        foreach(QString line,lines)
+        {
+            QRegularExpressionMatch match;
+            if (line.startsWith("Input #")) match = regExp(Input).match(line);
+            if (match.hasMatch() && match.captured(2) != "") matches++;
+            match = QRegularExpressionMatch();
+            if (line.contains("Duration: ")) match = regExp(Duration).match(line);
+            if (match.hasMatch() && match.captured(4) != "N/A") matches++;
+            if (!line.contains("Stream #")) continue;
+            match = regExp(VideoStream).match(line);
+            if (!match.hasMatch()) match = regExp(SequenceStream).match(line);
+            if (match.hasMatch() && match.captured(1).toInt() > 0)
+            {
+                matches++;
+                if (regExp(PixelFormat).match(line).hasMatch()) matches++;
+                continue;
+            }
+            match = regExp(AudioStream).match(line);
+            if (match.hasMatch() && match.captured(1).toInt() > 0) matches++;
+        }
+        qint64 infoTime = timer.nsecsElapsed();
+        out << "Media infos: " << matches << " matches, " << infoTime/1000 << " us, " << infoTime/qMax(1,lines.count()) << " ns/line" << "\n";
+
+        //muxers and codecs lists, as read by FFmpeg when it starts
+        timer.restart();
+        matches = 0;
+        foreach(QString line,lines)
+        {
+            QRegularExpressionMatch match = regExp(Muxer).match(line);
+            if (match.hasMatch() && match.captured(1).trimmed() != "" && match.captured(2).trimmed() != "") matches++;
+            match = regExp(Codec).match(line);
+            if (match.hasMatch() && match.captured(7) != "" && match.captured(8) != "") matches++;
+            //the muxer infos are on lines starting with a space
+            if (!line.startsWith(" ")) continue;
+            if (regExp(MuxerVideoCodec).match(line).hasMatch()) matches++;
+            if (regExp(MuxerAudioCodec).match(line).hasMatch()) matches++;
+            match = regExp(MuxerExtensions).match(line);
+            if (match.hasMatch() && match.captured(1).split(",").count() > 0) matches++;
+        }
+        qint64 listsTime = timer.nsecsElapsed();
+        out << "Muxers and codecs: " << matches << " matches, " << listsTime/1000 << " us, " << listsTime/qMax(1,lines.count()) << " ns/line" << "\n";
+
+        //compiled patterns, on all the lines
+        timer.restart();
+        matches = 0;
+        foreach(QString line,lines)
+        {
+            foreach(Pattern pattern,patterns)
+            {
+                if (regExp(pattern).match(line).hasMatch()) matches++;
+            }
+        }
+        qint64 compiledTime = timer.nsecsElapsed();
+        out << "Compiled patterns: " << matches << " matches, " << compiledTime/1000 << " us, " << compiledTime/qMax(1,lines.count()) << " ns/line" << "\n";
+
+        //patterns built for each line, as before
+        timer.restart();
+        matches = 0;
+        foreach(QString line,lines)
+        {
+            foreach(Pattern pattern,patterns)
+            {
+                QRegularExpression re(regExp(pattern).pattern());
+                if (re.match(line).hasMatch()) matches++;
+            }
+        }
+        qint64 uncompiledTime = timer.nsecsElapsed();
+        out << "Patterns built on each line: " << matches << " matches, " << uncompiledTime/1000 << " us, " << uncompiledTime/qMax(1,lines.count()) << " ns/line" << "\n";
+        out.flush();
+    }
+
+    return 0;
+}
+
+QVector<QRegularExpression> FFOutputParser::compileRegExps()
+{
+    //in the same order as the Pattern enum
+    QVector<QRegularExpression> regExps;
+    regExps << QRegularExpression("Input #\\d+, ([\\w+,]+) from '(.+)':");
+    regExps << QRegularExpression("Duration: (?:(\\d\\d):(\\d\\d):(\\d\\d.\\d\\d), )?(?:(N\\/A), )?");
+    regExps << QRegularExpression("Stream #.+Video: .+, (\\d+)x(\\d+).+, (\\d{1,3}(?:\\.\\d{0,3})?) fps");
+    regExps << QRegularExpression("Stream #.+Video: .+, (\\d+)x(\\d+)");
+    regExps << QRegularExpression("Stream #.+Video: [^,]+, (\\w+)");
+    regExps << QRegularExpression("Stream #.+Audio: .+, (\\d{4,6}) Hz");
+    regExps << QRegularExpression("[D. ]E (\\w+)\\s+(.+)");
+    regExps << QRegularExpression("Default video codec:\\s*(.+)\\.");
+    regExps << QRegularExpression("Default audio codec:\\s*(.+)\\.");
+    regExps << QRegularExpression("Common extensions:\\s*(.+)\\.");
+    regExps << QRegularExpression("([D.])([E.])([VAS])([I.])([L.])([S.]) (\\w+) +([^\\(\\n]+)");
+    regExps << QRegularExpression("(\"[^\"]*\"|[\\S]+)");
+    regExps << QRegularExpression("{(#+)}");
+    regExps << QRegularExpression("(\\d+)");
+    regExps << QRegularExpression("(9|10|12|14|16)(le|be)?$");
+    regExps << QRegularExpression("^bench:\\s+(\\d+) user\\s+(\\d+) sys\\s+(\\d+) real (\\w+)");
+    regExps << QRegularExpression("^bench: utime=([\\d.]+)s stime=([\\d.]+)s rtime=([\\d.]+)s");
+    regExps << QRegularExpression("^bench: maxrss=(\\d+)");
+
+    //JIT compile now rather than on the first match
+    for (int i = 0 ; i < regExps.count() ; i++)
+    {
+        regExps[i].optimize();
+    }
+
+    return regExps;
+}
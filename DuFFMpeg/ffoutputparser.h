@@ -0,0 +1,80 @@
+#ifndef FFOUTPUTPARSER_H
+#define FFOUTPUTPARSER_H
+
+#include "ffobject.h"
+
+#include <QRegularExpression>
+#include <QVector>
+#include <QStringList>
+
+/**
+ * @brief The FFOutputParser class Helps parsing the outputs of FFmpeg.
+ * The regular expressions are compiled and optimized only once, and shared by all the parsers.
+ * An instance splits a stream of output into complete lines, keeping incomplete ones until the end of the line is received.
+ */
+class FFOutputParser : public FFObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief The Pattern enum The regular expressions used to parse FFmpeg outputs
+     */
+    enum Pattern {
+        Input, // -i: Input #0, format from 'file':
+        Duration, // -i: Duration: 00:00:00.00
+        VideoStream, // -i: Stream #0:0: Video: codec, pix_fmt, WxH, fps
+        SequenceStream, // -i: Stream #0:0: Video: codec, pix_fmt, WxH
+        PixelFormat, // -i: the pixel format of a video stream
+        AudioStream, // -i: Stream #0:1: Audio: codec, 48000 Hz
+        Muxer, // -formats: line of the list
+        MuxerVideoCodec, // -h muxer=name: Default video codec
+        MuxerAudioCodec, // -h muxer=name: Default audio codec
+        MuxerExtensions, // -h muxer=name: Common extensions
+        Codec, // -codecs: line of the list
+        Argument, // an argument of a command line, which may be quoted
+        SequenceDigits, // {###} in a file name
+        Digits, // a group of digits
+        HighBitDepth, // the pixel format has more than 8 bits per component
+        BenchmarkStage, // -benchmark_all: bench: user sys real (in µs) of a stage
+        BenchmarkTimes, // -benchmark: bench: utime stime rtime of the process
+        BenchmarkMemory // -benchmark: bench: maxrss of the process
+    };
+    Q_ENUM(Pattern)
+
+    explicit FFOutputParser(QObject *parent = nullptr);
+
+    /**
+     * @brief regExp Gets a compiled regular expression
+     * @param pattern The pattern
+     * @return The regular expression, which can be used from any thread
+     */
+    static const QRegularExpression &regExp(Pattern pattern);
+    /**
+     * @brief addData Adds a chunk of output
+     * @param data The output, which can end in the middle of a line
+     * @return The lines completed by this chunk, without the line feeds
+     */
+    QStringList addData(const QString &data);
+    /**
+     * @brief flush Gets the incomplete line kept from the previous chunks, when the output has ended
+     * @return The remaining output
+     */
+    QString flush();
+    /**
+     * @brief benchmark Measures the time needed to parse a recorded FFmpeg output, and prints the results on the standard output
+     * The output is parsed at its size and at 100 times its size, cut in chunks like the ones read from a process,
+     * with the same filters and patterns as the media infos, muxers and codecs parsers
+     * @param fileName The file containing the recorded output, e.g. "Test Medias/FFmpeg outputs/probe-formats-codecs.txt"
+     * @return 0 on success, 1 if the file can not be read
+     */
+    static int benchmark(QString fileName);
+
+private:
+    /**
+     * @brief _pending The end of the output which is not a complete line yet
+     */
+    QString _pending;
+    static QVector<QRegularExpression> compileRegExps();
+};
+
+#endif // FFOUTPUTPARSER_H
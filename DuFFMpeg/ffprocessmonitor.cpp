@@ -0,0 +1,96 @@
+#include "ffprocessmonitor.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFProcessMonitor::FFProcessMonitor(QObject *parent) : FFObject(parent)
+{
+
+}
+
+FFProcessSample FFProcessMonitor::sample(qint64 pid, const FFProcessSample &previous)
+{
+    FFProcessSample s;
+#ifdef Q_OS_LINUX
+    QString procPath = "/proc/" + QString::number(pid) + "/";
+
+    //stat: the name of the process is between parenthesis and can contain spaces, the fields are after the last one
+    QStringList stat = readProcFile(procPath + "stat");
+    if (stat.count() == 0) return s;
+    QString statLine = stat.first();
+    QStringList fields = statLine.mid(statLine.lastIndexOf(')') + 2).split(' ');
+    //fields start at the state (3rd field in proc(5)): utime is the 14th, stime the 15th, num_threads the 20th
+    if (fields.count() < 18) return s;
+    qint64 ticks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+    s.cpuTime = ticks * 1000 / clockTicks();
+    s.threads = fields.at(17).toInt();
+
+    //status: memory (in kB) and context switches
+    QStringList status = readProcFile(procPath + "status");
+    s.memory = procValue(status,"VmRSS:") * 1024;
+    s.peakMemory = procValue(status,"VmHWM:") * 1024;
+    s.voluntaryContextSwitches = procValue(status,"voluntary_ctxt_switches:");
+    s.involuntaryContextSwitches = procValue(status,"nonvoluntary_ctxt_switches:");
+
+    //io: only readable by the owner of the process, it stays at 0 otherwise
+    QStringList io = readProcFile(procPath + "io");
+    s.readBytes = procValue(io,"read_bytes:");
+    s.writtenBytes = procValue(io,"write_bytes:");
+
+    s.time = QDateTime::currentMSecsSinceEpoch();
+    s.valid = true;
+
+    //CPU usage since the previous sample
+    if (previous.valid && s.time > previous.time)
+    {
+        s.cpuUsage = double(s.cpuTime - previous.cpuTime) * 100.0 / (s.time - previous.time);
+        if (s.cpuUsage < 0) s.cpuUsage = 0.0;
+    }
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(previous);
+#endif
+    return s;
+}
+
+QStringList FFProcessMonitor::readProcFile(QString fileName)
+{
+    //files in /proc have a size of 0, they must be read with a stream until the end
+    QStringList lines;
+    QFile procFile(fileName);
+    if (!procFile.open(QIODevice::ReadOnly | QIODevice::Text)) return lines;
+
+    QTextStream procStream(&procFile);
+    QString line = procStream.readLine();
+    while (!line.isNull())
+    {
+        lines << line;
+        line = procStream.readLine();
+    }
+
+    procFile.close();
+    return lines;
+}
+
+qint64 FFProcessMonitor::procValue(const QStringList &lines, QString key)
+{
+    foreach(QString line,lines)
+    {
+        if (line.startsWith(key)) return line.mid(key.count()).trimmed().section(' ',0,0).toLongLong();
+    }
+    return 0;
+}
+
+qint64 FFProcessMonitor::clockTicks()
+{
+#ifdef Q_OS_LINUX
+    static qint64 ticks = sysconf(_SC_CLK_TCK);
+    if (ticks > 0) return ticks;
+#endif
+    return 100;
+}
@@ -0,0 +1,88 @@
+#ifndef FFPROCESSMONITOR_H
+#define FFPROCESSMONITOR_H
+
+#include "ffobject.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QMetaType>
+
+/**
+ * @brief The FFProcessSample struct The resources used by a process, read at a given time
+ */
+struct FFProcessSample
+{
+    /**
+     * @brief valid False if the process could not be read (finished, or not on Linux)
+     */
+    bool valid = false;
+    /**
+     * @brief time When the sample has been read, in milliseconds since epoch
+     */
+    qint64 time = 0;
+    /**
+     * @brief cpuTime The CPU time used by the process since it started (user + system), in milliseconds
+     */
+    qint64 cpuTime = 0;
+    /**
+     * @brief cpuUsage The CPU used since the previous sample, in percent of one core (can exceed 100 with several threads)
+     */
+    double cpuUsage = 0.0;
+    /**
+     * @brief memory The resident memory, in bytes
+     */
+    qint64 memory = 0;
+    /**
+     * @brief peakMemory The highest resident memory since the process started, in bytes
+     */
+    qint64 peakMemory = 0;
+    /**
+     * @brief readBytes The bytes the process has read from the storage
+     */
+    qint64 readBytes = 0;
+    /**
+     * @brief writtenBytes The bytes the process has written to the storage
+     */
+    qint64 writtenBytes = 0;
+    qint64 voluntaryContextSwitches = 0;
+    qint64 involuntaryContextSwitches = 0;
+    int threads = 0;
+};
+Q_DECLARE_METATYPE(FFProcessSample)
+
+/**
+ * @brief The FFProcessMonitor class Reads the resources used by a running process from /proc/<pid>/stat, status and io.
+ * Reading the files is cheap enough to be done every second for each encoding.
+ */
+class FFProcessMonitor : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFProcessMonitor(QObject *parent = nullptr);
+
+    /**
+     * @brief sample Reads the resources currently used by a process
+     * @param pid The process id
+     * @param previous The previous sample of the same process, used to compute the CPU usage
+     * @return The sample, invalid if the process can't be read
+     */
+    static FFProcessSample sample(qint64 pid, const FFProcessSample &previous = FFProcessSample());
+    /**
+     * @brief readProcFile Reads a whole file from /proc
+     * @return The lines of the file, empty if it can't be read
+     */
+    static QStringList readProcFile(QString fileName);
+    /**
+     * @brief procValue Gets the number following the key in the lines of a /proc file, 0 if the key is not found
+     */
+    static qint64 procValue(const QStringList &lines, QString key);
+
+private:
+    /**
+     * @brief clockTicks The number of clock ticks per second used in /proc/<pid>/stat
+     */
+    static qint64 clockTicks();
+};
+
+#endif // FFPROCESSMONITOR_H
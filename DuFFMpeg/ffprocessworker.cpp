@@ -0,0 +1,227 @@
+#include "ffprocessworker.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFProcessWorker::FFProcessWorker(QObject *parent) : FFObject(parent)
+{
+
+}
+
+void FFProcessWorker::startJob(int id, QString program, QStringList arguments, FFFrameFeeder *feeder)
+{
+    //the process belongs to this thread, its pipes are read here
+    QProcess *process = new QProcess(this);
+    process->setProgram(program);
+    process->setArguments(arguments);
+    connect(process,SIGNAL(readyReadStandardError()),this,SLOT(stdError()));
+    connect(process,SIGNAL(readyReadStandardOutput()),this,SLOT(stdOutput()));
+    connect(process,SIGNAL(started()),this,SLOT(started()));
+    connect(process,SIGNAL(finished(int)),this,SLOT(finished()));
+    connect(process,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(errorOccurred(QProcess::ProcessError)));
+    _jobs.insert(process,id);
+    _parsers.insert(process,new FFProgressParser(process));
+    _lineParsers.insert(process,new FFOutputParser(process));
+    _benchmarkParsers.insert(process,new FFBenchmarkParser(process));
+    if (feeder != nullptr)
+    {
+        feeder->setParent(process);
+        connect(feeder,SIGNAL(debugInfo(QString)),this,SIGNAL(debugInfo(QString)));
+        _feeders.insert(process,feeder);
+    }
+
+    process->start(QIODevice::ReadWrite);
+}
+
+void FFProcessWorker::startBatchJob(int id, FFBatch batch)
+{
+    FFBatchJob *job = new FFBatchJob(batch,this);
+    connect(job,SIGNAL(started(qint64)),this,SLOT(batchStarted(qint64)));
+    connect(job,SIGNAL(processFinished(qint64)),this,SLOT(batchProcessFinished(qint64)));
+    connect(job,SIGNAL(progress(FFProgress)),this,SLOT(batchProgress(FFProgress)));
+    connect(job,SIGNAL(output(QString)),this,SLOT(batchOutput(QString)));
+    connect(job,SIGNAL(finished(int)),this,SLOT(batchFinished(int)));
+    connect(job,SIGNAL(debugInfo(QString)),this,SIGNAL(debugInfo(QString)));
+    _batchJobs.insert(job,id);
+    job->start();
+}
+
+void FFProcessWorker::stopJob(int id, int timeout)
+{
+    FFBatchJob *job = _batchJobs.key(id,nullptr);
+    if (job != nullptr)
+    {
+        job->stop(timeout);
+        return;
+    }
+
+    QProcess *process = _jobs.key(id,nullptr);
+    if (process == nullptr) return;
+    if (_stoppingJobs.contains(process)) return;
+    _stoppingJobs.insert(process,Quit);
+
+    //FFmpeg finishes writing the output when it receives q, or at the end of its input when it reads the frames on stdin
+    FFFrameFeeder *feeder = _feeders.value(process,nullptr);
+    if (feeder != nullptr) feeder->stop();
+    else process->write("q\n");
+
+    //escalate if it does not respond
+    QTimer *stopTimer = new QTimer(process);
+    stopTimer->setSingleShot(true);
+    stopTimer->setInterval(timeout);
+    connect(stopTimer,SIGNAL(timeout()),this,SLOT(escalateStop()));
+    stopTimer->start();
+}
+
+void FFProcessWorker::stdError()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    FFOutputParser *parser = _lineParsers.value(process,nullptr);
+    if (parser == nullptr) return;
+    QStringList lines = filterBenchmark(process,parser->addData(process->readAllStandardError()));
+    if (lines.count() > 0) emit jobOutput(_jobs.value(process,-1),lines.join("\n") + "\n");
+}
+
+void FFProcessWorker::stdOutput()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    //progress reports
+    FFProgressParser *parser = _parsers.value(process,nullptr);
+    if (parser == nullptr) return;
+    if (parser->addData(process->readAllStandardOutput()))
+    {
+        emit jobProgress(_jobs.value(process,-1),parser->progress());
+    }
+}
+
+void FFProcessWorker::started()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    emit jobStarted(_jobs.value(process,-1),process->processId());
+    FFFrameFeeder *feeder = _feeders.value(process,nullptr);
+    if (feeder != nullptr) feeder->start(process);
+}
+
+void FFProcessWorker::finished()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    int exitCode = -1;
+    if (process->exitStatus() == QProcess::NormalExit) exitCode = process->exitCode();
+    endJob(process,exitCode);
+}
+
+void FFProcessWorker::errorOccurred(QProcess::ProcessError e)
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr) return;
+    emit jobError(_jobs.value(process,-1),e);
+    //the process will not emit finished if it could not start
+    if (e == QProcess::FailedToStart) endJob(process,-1);
+}
+
+void FFProcessWorker::escalateStop()
+{
+    QTimer *stopTimer = qobject_cast<QTimer *>(sender());
+    if (stopTimer == nullptr) return;
+    QProcess *process = qobject_cast<QProcess *>(stopTimer->parent());
+    if (process == nullptr) return;
+    if (!_stoppingJobs.contains(process)) return;
+
+    if (_stoppingJobs.value(process) == Quit)
+    {
+        emit debugInfo("FFmpeg did not quit, terminating the process.");
+        _stoppingJobs.insert(process,Terminate);
+        process->terminate();
+        stopTimer->start();
+    }
+    else
+    {
+        emit debugInfo("FFmpeg did not terminate, killing the process.");
+        process->kill();
+    }
+}
+
+void FFProcessWorker::batchStarted(qint64 pid)
+{
+    FFBatchJob *job = qobject_cast<FFBatchJob *>(sender());
+    if (job == nullptr) return;
+    emit jobStarted(_batchJobs.value(job,-1),pid);
+}
+
+void FFProcessWorker::batchProcessFinished(qint64 pid)
+{
+    FFBatchJob *job = qobject_cast<FFBatchJob *>(sender());
+    if (job == nullptr) return;
+    emit jobProcessFinished(_batchJobs.value(job,-1),pid);
+}
+
+void FFProcessWorker::batchProgress(FFProgress progress)
+{
+    FFBatchJob *job = qobject_cast<FFBatchJob *>(sender());
+    if (job == nullptr) return;
+    emit jobProgress(_batchJobs.value(job,-1),progress);
+}
+
+void FFProcessWorker::batchOutput(QString output)
+{
+    FFBatchJob *job = qobject_cast<FFBatchJob *>(sender());
+    if (job == nullptr) return;
+    emit jobOutput(_batchJobs.value(job,-1),output);
+}
+
+void FFProcessWorker::batchFinished(int exitCode)
+{
+    FFBatchJob *job = qobject_cast<FFBatchJob *>(sender());
+    if (job == nullptr) return;
+    int id = _batchJobs.take(job);
+    job->deleteLater();
+    emit jobFinished(id,exitCode);
+}
+
+void FFProcessWorker::endJob(QProcess *process, int exitCode)
+{
+    int id = _jobs.take(process);
+    _stoppingJobs.remove(process);
+
+    //send the last line if it did not end with a line feed
+    FFOutputParser *lineParser = _lineParsers.take(process);
+    if (lineParser != nullptr)
+    {
+        QStringList remaining = filterBenchmark(process,QStringList(lineParser->flush()));
+        if (remaining.count() > 0 && remaining.at(0) != "") emit jobOutput(id,remaining.at(0) + "\n");
+    }
+
+    FFBenchmarkParser *benchmarkParser = _benchmarkParsers.take(process);
+    if (benchmarkParser != nullptr)
+    {
+        FFBenchmark benchmark = benchmarkParser->benchmark();
+        if (benchmark.valid || benchmark.stages.count() > 0) emit jobBenchmark(id,benchmark);
+    }
+
+    FFFrameFeeder *feeder = _feeders.take(process);
+    if (feeder != nullptr) feeder->stop();
+
+    //the parsers and the feeder are children of the process
+    _parsers.remove(process);
+    process->deleteLater();
+    emit jobFinished(id,exitCode);
+}
+
+QStringList FFProcessWorker::filterBenchmark(QProcess *process, const QStringList &lines)
+{
+    FFBenchmarkParser *parser = _benchmarkParsers.value(process,nullptr);
+    if (parser == nullptr) return lines;
+
+    //there is one line per frame and per stage, they would flood the logs
+    QStringList output;
+    foreach(QString line,lines)
+    {
+        if (!parser->addLine(line)) output << line;
+    }
+    return output;
+}
@@ -0,0 +1,141 @@
+#ifndef FFPROCESSWORKER_H
+#define FFPROCESSWORKER_H
+
+#include "ffobject.h"
+
+#include <QProcess>
+#include <QTimer>
+#include <QMap>
+
+#include "ffprogressparser.h"
+#include "ffoutputparser.h"
+#include "ffbenchmarkparser.h"
+#include "ffframefeeder.h"
+#include "ffbatchjob.h"
+
+/**
+ * @brief The FFProcessWorker class Runs the encoding FFmpeg processes and reads their outputs.
+ * It lives in its own thread, so the pipes are drained even when the UI is busy
+ * and FFmpeg never blocks when writing its output.
+ * All communications with the FFmpeg manager go through queued signals and slots, using job ids.
+ */
+class FFProcessWorker : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFProcessWorker(QObject *parent = nullptr);
+
+public slots:
+    /**
+     * @brief startJob Launches a new FFmpeg process
+     * @param id The id of the job
+     * @param program The path to the FFmpeg binary
+     * @param arguments The arguments
+     * @param feeder Writes the frames on the standard input, owned by the process; nullptr if FFmpeg reads its inputs itself
+     */
+    void startJob(int id, QString program, QStringList arguments, FFFrameFeeder *feeder = nullptr);
+    /**
+     * @brief startBatchJob Launches the conversion of an image sequence by several processes
+     * @param id The id of the job
+     * @param batch The conversion
+     */
+    void startBatchJob(int id, FFBatch batch);
+    /**
+     * @brief stopJob Asks a process to quit, then terminates (SIGTERM) and kills it (SIGKILL) if it does not respond
+     * @param id The id of the job
+     * @param timeout The delay before each escalation. In milliseconds.
+     */
+    void stopJob(int id, int timeout);
+
+signals:
+    /**
+     * @brief jobStarted Emitted when the process has started; a batch job emits it for each of its processes
+     */
+    void jobStarted(int id, qint64 pid);
+    /**
+     * @brief jobProcessFinished Emitted when one of the processes of a batch job has finished, the job goes on with the others
+     */
+    void jobProcessFinished(int id, qint64 pid);
+    /**
+     * @brief jobOutput Emitted when the process outputs on stderr
+     * The output is sent by complete lines. The standard output is used for the progress reports
+     */
+    void jobOutput(int id, QString output);
+    /**
+     * @brief jobProgress Emitted each time the process outputs new stats
+     */
+    void jobProgress(int id, FFProgress progress);
+    /**
+     * @brief jobBenchmark Emitted before jobFinished when the process has reported benchmark stats (-benchmark and -benchmark_all)
+     */
+    void jobBenchmark(int id, FFBenchmark benchmark);
+    /**
+     * @brief jobError Emitted when an error occured with the process
+     */
+    void jobError(int id, QProcess::ProcessError error);
+    /**
+     * @brief jobFinished Emitted when the process has finished, or could not start
+     * @param exitCode The exit code of FFmpeg, -1 if it did not start or crashed
+     */
+    void jobFinished(int id, int exitCode);
+    void debugInfo(QString log);
+
+private slots:
+    void stdError();
+    void stdOutput();
+    void started();
+    void finished();
+    void errorOccurred(QProcess::ProcessError e);
+    void escalateStop();
+    //batch jobs signals
+    void batchStarted(qint64 pid);
+    void batchProcessFinished(qint64 pid);
+    void batchProgress(FFProgress progress);
+    void batchOutput(QString output);
+    void batchFinished(int exitCode);
+
+private:
+    /**
+     * @brief The StopStage enum The latest request sent to a process being stopped
+     */
+    enum StopStage { Quit, Terminate };
+
+    /**
+     * @brief jobs The running processes, and their job id
+     */
+    QMap<QProcess *, int> _jobs;
+    /**
+     * @brief stoppingJobs The processes which have been asked to stop, and the latest request sent to them
+     */
+    QMap<QProcess *, StopStage> _stoppingJobs;
+    /**
+     * @brief parsers The progress parser of each process
+     */
+    QMap<QProcess *, FFProgressParser *> _parsers;
+    /**
+     * @brief lineParsers Split the standard error of each process in lines
+     */
+    QMap<QProcess *, FFOutputParser *> _lineParsers;
+    /**
+     * @brief benchmarkParsers Take the benchmark lines out of the standard error of each process
+     */
+    QMap<QProcess *, FFBenchmarkParser *> _benchmarkParsers;
+    /**
+     * @brief feeders The processes reading their frames on the standard input, and their feeder
+     */
+    QMap<QProcess *, FFFrameFeeder *> _feeders;
+    /**
+     * @brief batchJobs The running sequence conversions, and their job id
+     */
+    QMap<FFBatchJob *, int> _batchJobs;
+    /**
+     * @brief filterBenchmark Parses the benchmark lines and removes them from the output
+     */
+    QStringList filterBenchmark(QProcess *process, const QStringList &lines);
+    /**
+     * @brief endJob Removes a process which has finished
+     */
+    void endJob(QProcess *process, int exitCode);
+};
+
+#endif // FFPROCESSWORKER_H
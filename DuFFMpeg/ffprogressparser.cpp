@@ -0,0 +1,80 @@
+#include "ffprogressparser.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+FFProgressParser::FFProgressParser(QObject *parent) : FFObject(parent)
+{
+
+}
+
+bool FFProgressParser::addData(const QByteArray &data)
+{
+    _buffer.append(data);
+
+    bool complete = false;
+    int start = 0;
+    int end = _buffer.indexOf('\n',start);
+    while (end >= 0)
+    {
+        if (parseLine(_buffer.mid(start,end-start))) complete = true;
+        start = end + 1;
+        end = _buffer.indexOf('\n',start);
+    }
+    //keep the incomplete line for the next read
+    _buffer.remove(0,start);
+
+    return complete;
+}
+
+FFProgress FFProgressParser::progress() const
+{
+    return _progress;
+}
+
+void FFProgressParser::reset()
+{
+    _buffer.clear();
+    _current = FFProgress();
+    _progress = FFProgress();
+}
+
+bool FFProgressParser::parseLine(const QByteArray &line)
+{
+    int separator = line.indexOf('=');
+    if (separator <= 0) return false;
+
+    QByteArray key = line.left(separator).trimmed();
+    QByteArray value = line.mid(separator+1).trimmed();
+
+    //values are N/A until the first frame is encoded, toInt and toDouble then return 0
+    if (key == "frame") _current.frame = value.toInt();
+    else if (key == "fps") _current.fps = value.toDouble();
+    //out_time_ms is also in microseconds, it is the only one available in older versions
+    else if (key == "out_time_us" || key == "out_time_ms") _current.outTime = value.toLongLong();
+    else if (key == "total_size") _current.totalSize = value.toLongLong();
+    else if (key == "bitrate")
+    {
+        //kbits/s
+        value.replace("kbits/s","");
+        _current.bitrate = value.toDouble() * 1000;
+    }
+    else if (key == "speed")
+    {
+        value.replace("x","");
+        _current.speed = value.toDouble();
+    }
+    else if (key == "dup_frames") _current.dupFrames = value.toInt();
+    else if (key == "drop_frames") _current.dropFrames = value.toInt();
+    else if (key == "stream_0_0_q") _current.quality = value.toDouble();
+    else if (key == "progress")
+    {
+        //end of the block
+        _current.end = value == "end";
+        _progress = _current;
+        return true;
+    }
+
+    return false;
+}
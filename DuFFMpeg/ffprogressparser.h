@@ -0,0 +1,103 @@
+#ifndef FFPROGRESSPARSER_H
+#define FFPROGRESSPARSER_H
+
+#include "ffobject.h"
+
+#include <QByteArray>
+#include <QMetaType>
+
+/**
+ * @brief The FFProgress struct The stats of an encoding process, as reported by FFmpeg -progress
+ */
+struct FFProgress
+{
+    /**
+     * @brief frame The number of frames which have been encoded
+     */
+    int frame = 0;
+    /**
+     * @brief fps The number of frames encoded per second
+     */
+    double fps = 0.0;
+    /**
+     * @brief outTime The duration which has been encoded, in microseconds
+     */
+    qint64 outTime = 0;
+    /**
+     * @brief totalSize The current size of the output, in bytes
+     */
+    qint64 totalSize = 0;
+    /**
+     * @brief bitrate The average bitrate of the output, in bits/s
+     */
+    double bitrate = 0.0;
+    /**
+     * @brief speed The encoding speed, relative to the duration of the media
+     */
+    double speed = 0.0;
+    /**
+     * @brief dupFrames The number of frames which have been duplicated to keep the framerate
+     */
+    int dupFrames = 0;
+    /**
+     * @brief dropFrames The number of frames which have been dropped to keep the framerate
+     */
+    int dropFrames = 0;
+    /**
+     * @brief quality The quantizer of the first stream of the first output (q)
+     */
+    double quality = 0.0;
+    /**
+     * @brief end True when this is the last report of the process
+     */
+    bool end = false;
+};
+Q_DECLARE_METATYPE(FFProgress)
+
+/**
+ * @brief The FFProgressParser class Parses the key=value blocks written by FFmpeg when using -progress
+ * The data is parsed incrementally: lines split across several reads are kept until they are complete,
+ * and a report is available each time a block ends with its "progress" key.
+ */
+class FFProgressParser : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFProgressParser(QObject *parent = nullptr);
+
+    /**
+     * @brief addData Parses new data read from the process
+     * @param data The data
+     * @return true if at least one block has been completed, the latest one is then returned by progress()
+     */
+    bool addData(const QByteArray &data);
+    /**
+     * @brief progress The latest complete report
+     */
+    FFProgress progress() const;
+    /**
+     * @brief reset Clears the pending data and the latest report
+     */
+    void reset();
+
+private:
+    /**
+     * @brief _buffer The data after the last line feed, not parsed yet
+     */
+    QByteArray _buffer;
+    /**
+     * @brief _current The block being parsed
+     */
+    FFProgress _current;
+    /**
+     * @brief _progress The latest complete block
+     */
+    FFProgress _progress;
+    /**
+     * @brief parseLine Parses one key=value line
+     * @return true if the line ends a block
+     */
+    bool parseLine(const QByteArray &line);
+};
+
+#endif // FFPROGRESSPARSER_H
@@ -5,6 +5,11 @@ FFQueueItem::FFQueueItem(QList<FFMediaInfo *> inputs, QList<FFMediaInfo *> outpu
     _inputMedias = inputs;
     _outputMedias = outputs;
     _status = Waiting;
+    _estimatedMemory = 0;
+    _benchmarkEnabled = false;
+    _output = new FFOutputBuffer(0,this);
+    _metrics = new FFMetrics(this);
+    resetStats();
     emit queued();
 }
 
@@ -13,6 +18,11 @@ FFQueueItem::FFQueueItem(FFMediaInfo *input, QList<FFMediaInfo *> outputs, QObje
     _inputMedias << input;
     _outputMedias = outputs;
     _status = Waiting;
+    _estimatedMemory = 0;
+    _benchmarkEnabled = false;
+    _output = new FFOutputBuffer(0,this);
+    _metrics = new FFMetrics(this);
+    resetStats();
 }
 
 FFQueueItem::FFQueueItem(FFMediaInfo *input, FFMediaInfo *output, QObject *parent) : FFObject(parent)
@@ -20,6 +30,11 @@ FFQueueItem::FFQueueItem(FFMediaInfo *input, FFMediaInfo *output, QObject *paren
     _inputMedias << input;
     _outputMedias << output;
     _status = Waiting;
+    _estimatedMemory = 0;
+    _benchmarkEnabled = false;
+    _output = new FFOutputBuffer(0,this);
+    _metrics = new FFMetrics(this);
+    resetStats();
 }
 
 QList<FFMediaInfo *> FFQueueItem::getInputMedias()
@@ -91,3 +106,217 @@ void FFQueueItem::setStatus(Status st)
     else if (_status == Stopped) emit encodingStopped();
     else if (_status == Waiting) emit queued();
 }
+
+QTime FFQueueItem::startTime() const
+{
+    return _startTime;
+}
+
+void FFQueueItem::setStartTime(const QTime &startTime)
+{
+    _startTime = startTime;
+}
+
+int FFQueueItem::currentFrame() const
+{
+    return _currentFrame;
+}
+
+void FFQueueItem::setCurrentFrame(int currentFrame)
+{
+    _currentFrame = currentFrame;
+}
+
+double FFQueueItem::outputSize(FFMediaInfo::SizeUnit unit) const
+{
+    double s = _outputSize;
+    if (unit == FFMediaInfo::KB) s = s/1024;
+    if (unit == FFMediaInfo::MB) s = s/1024/1024;
+    return s;
+}
+
+void FFQueueItem::setOutputSize(double outputSize)
+{
+    _outputSize = outputSize;
+}
+
+double FFQueueItem::outputBitrate(FFMediaInfo::BitrateUnit unit) const
+{
+    //FFmpeg reports the bitrate in kbits/s of 1000 bits
+    double bitrate = _outputBitrate;
+    if (unit == FFMediaInfo::Kbps) bitrate = bitrate/1000;
+    if (unit == FFMediaInfo::Mbps) bitrate = bitrate/1000/1000;
+    return bitrate;
+}
+
+void FFQueueItem::setOutputBitrate(int outputBitrate)
+{
+    _outputBitrate = outputBitrate;
+}
+
+double FFQueueItem::encodingSpeed() const
+{
+    return _encodingSpeed;
+}
+
+void FFQueueItem::setEncodingSpeed(double encodingSpeed)
+{
+    _encodingSpeed = encodingSpeed;
+}
+
+double FFQueueItem::encodingFramerate() const
+{
+    return _encodingFramerate;
+}
+
+void FFQueueItem::setEncodingFramerate(double encodingFramerate)
+{
+    _encodingFramerate = encodingFramerate;
+}
+
+qint64 FFQueueItem::outputTime() const
+{
+    return _outputTime;
+}
+
+void FFQueueItem::setOutputTime(qint64 outputTime)
+{
+    _outputTime = outputTime;
+}
+
+int FFQueueItem::duplicatedFrames() const
+{
+    return _duplicatedFrames;
+}
+
+void FFQueueItem::setDuplicatedFrames(int duplicatedFrames)
+{
+    _duplicatedFrames = duplicatedFrames;
+}
+
+int FFQueueItem::droppedFrames() const
+{
+    return _droppedFrames;
+}
+
+void FFQueueItem::setDroppedFrames(int droppedFrames)
+{
+    _droppedFrames = droppedFrames;
+}
+
+double FFQueueItem::quality() const
+{
+    return _quality;
+}
+
+void FFQueueItem::setQuality(double quality)
+{
+    _quality = quality;
+}
+
+QTime FFQueueItem::timeRemaining() const
+{
+    return _timeRemaining;
+}
+
+void FFQueueItem::setTimeRemaining(const QTime &timeRemaining)
+{
+    _timeRemaining = timeRemaining;
+}
+
+void FFQueueItem::resetStats()
+{
+    _startTime = QTime(0,0,0);
+    _currentFrame = 0;
+    _outputSize = 0.0;
+    _outputBitrate = 0;
+    _encodingSpeed = 0.0;
+    _encodingFramerate = 0.0;
+    _outputTime = 0;
+    _duplicatedFrames = 0;
+    _droppedFrames = 0;
+    _quality = 0.0;
+    _timeRemaining = QTime(0,0,0);
+    _peakMemory = 0;
+    _processSample = FFProcessSample();
+    _processStartTime = QDateTime::currentMSecsSinceEpoch();
+    _maxCpuUsage = 0.0;
+    _metrics->clear();
+    _benchmark = FFBenchmark();
+}
+
+FFOutputBuffer *FFQueueItem::output()
+{
+    return _output;
+}
+
+FFMetrics *FFQueueItem::metrics()
+{
+    return _metrics;
+}
+
+qint64 FFQueueItem::estimatedMemory() const
+{
+    return _estimatedMemory;
+}
+
+void FFQueueItem::setEstimatedMemory(qint64 estimatedMemory)
+{
+    _estimatedMemory = estimatedMemory;
+}
+
+qint64 FFQueueItem::peakMemory() const
+{
+    return _peakMemory;
+}
+
+void FFQueueItem::setPeakMemory(qint64 peakMemory)
+{
+    _peakMemory = peakMemory;
+}
+
+FFProcessSample FFQueueItem::processSample() const
+{
+    return _processSample;
+}
+
+void FFQueueItem::setProcessSample(const FFProcessSample &processSample)
+{
+    if (!processSample.valid) return;
+    _processSample = processSample;
+    if (processSample.peakMemory > _peakMemory) _peakMemory = processSample.peakMemory;
+    if (processSample.cpuUsage > _maxCpuUsage) _maxCpuUsage = processSample.cpuUsage;
+}
+
+double FFQueueItem::maxCpuUsage() const
+{
+    return _maxCpuUsage;
+}
+
+double FFQueueItem::averageCpuUsage() const
+{
+    if (!_processSample.valid) return 0.0;
+    qint64 duration = _processSample.time - _processStartTime;
+    if (duration <= 0) return 0.0;
+    return double(_processSample.cpuTime) * 100.0 / duration;
+}
+
+bool FFQueueItem::isBenchmarkEnabled() const
+{
+    return _benchmarkEnabled;
+}
+
+void FFQueueItem::setBenchmarkEnabled(bool benchmarkEnabled)
+{
+    _benchmarkEnabled = benchmarkEnabled;
+}
+
+FFBenchmark FFQueueItem::benchmark() const
+{
+    return _benchmark;
+}
+
+void FFQueueItem::setBenchmark(const FFBenchmark &benchmark)
+{
+    _benchmark = benchmark;
+}
@@ -3,7 +3,13 @@
 
 #include "ffobject.h"
 
+#include <QTime>
+
 #include "ffmediainfo.h"
+#include "ffoutputbuffer.h"
+#include "ffprocessmonitor.h"
+#include "ffmetrics.h"
+#include "ffbenchmarkparser.h"
 
 class FFQueueItem : public FFObject
 {
@@ -29,6 +35,103 @@ public:
     FFMediaInfo *removeOutputMedia(QString fileName);
     Status getStatus();
 
+    //encoding stats
+    QTime startTime() const;
+    void setStartTime(const QTime &startTime);
+    int currentFrame() const;
+    void setCurrentFrame(int currentFrame);
+    double outputSize(FFMediaInfo::SizeUnit unit = FFMediaInfo::Bytes) const;
+    void setOutputSize(double outputSize);
+    double outputBitrate(FFMediaInfo::BitrateUnit unit = FFMediaInfo::Bits) const;
+    void setOutputBitrate(int outputBitrate);
+    double encodingSpeed() const;
+    void setEncodingSpeed(double encodingSpeed);
+    /**
+     * @brief encodingFramerate The number of frames encoded per second
+     */
+    double encodingFramerate() const;
+    void setEncodingFramerate(double encodingFramerate);
+    /**
+     * @brief outputTime The duration which has been encoded
+     * @return The duration in microseconds
+     */
+    qint64 outputTime() const;
+    void setOutputTime(qint64 outputTime);
+    int duplicatedFrames() const;
+    void setDuplicatedFrames(int duplicatedFrames);
+    int droppedFrames() const;
+    void setDroppedFrames(int droppedFrames);
+    /**
+     * @brief quality The quantizer of the first output stream (q)
+     */
+    double quality() const;
+    void setQuality(double quality);
+    QTime timeRemaining() const;
+    void setTimeRemaining(const QTime &timeRemaining);
+    /**
+     * @brief resetStats Resets the encoding stats before (re)launching the item
+     */
+    void resetStats();
+
+    /**
+     * @brief output The latest output of the FFmpeg process encoding this item
+     * The buffer is empty until the item is launched
+     */
+    FFOutputBuffer *output();
+    /**
+     * @brief metrics The time series of the stats of the encoding, recorded every second
+     * The series is cleared when the item is launched
+     */
+    FFMetrics *metrics();
+
+    //memory
+    /**
+     * @brief estimatedMemory The peak resident memory the FFmpeg processes were expected to use when the item was admitted
+     * @return The memory in bytes
+     */
+    qint64 estimatedMemory() const;
+    void setEstimatedMemory(qint64 estimatedMemory);
+    /**
+     * @brief peakMemory The highest resident memory measured for the FFmpeg process encoding this item, added up for all the processes of a sequence encoded by several processes
+     * @return The memory in bytes, 0 if it has not been measured
+     */
+    qint64 peakMemory() const;
+    void setPeakMemory(qint64 peakMemory);
+
+    //process telemetry
+    /**
+     * @brief processSample The latest resources measured for the FFmpeg process encoding this item
+     * When the encoding has finished, this is the last sample read before the process exited
+     */
+    FFProcessSample processSample() const;
+    /**
+     * @brief setProcessSample Sets the latest measure, and updates the peak memory and CPU usage
+     */
+    void setProcessSample(const FFProcessSample &processSample);
+    /**
+     * @brief maxCpuUsage The highest CPU usage measured between two samples
+     * @return The usage in percent of one core
+     */
+    double maxCpuUsage() const;
+    /**
+     * @brief averageCpuUsage The CPU usage since the process started
+     * @return The usage in percent of one core
+     */
+    double averageCpuUsage() const;
+
+    //profiling
+    /**
+     * @brief isBenchmarkEnabled When true, FFmpeg reports the time spent in each stage of the encoding (-benchmark and -benchmark_all)
+     */
+    bool isBenchmarkEnabled() const;
+    void setBenchmarkEnabled(bool benchmarkEnabled);
+    /**
+     * @brief benchmark The stats reported by FFmpeg when the benchmark is enabled
+     * @return The stats, invalid until the encoding has finished
+     */
+    FFBenchmark benchmark() const;
+    void setBenchmark(const FFBenchmark &benchmark);
+
 public slots:
     /**
      * @brief setStatus Changes the status of the item
@@ -49,6 +152,30 @@ private:
     QList<FFMediaInfo *> _inputMedias;
     QList<FFMediaInfo *> _outputMedias;
     Status _status;
+    //encoding stats
+    QTime _startTime;
+    int _currentFrame;
+    double _outputSize;
+    int _outputBitrate;
+    double _encodingSpeed;
+    double _encodingFramerate;
+    qint64 _outputTime;
+    int _duplicatedFrames;
+    int _droppedFrames;
+    double _quality;
+    QTime _timeRemaining;
+    FFOutputBuffer *_output;
+    FFMetrics *_metrics;
+    //memory
+    qint64 _estimatedMemory;
+    qint64 _peakMemory;
+    //process telemetry
+    FFProcessSample _processSample;
+    qint64 _processStartTime;
+    double _maxCpuUsage;
+    //profiling
+    bool _benchmarkEnabled;
+    FFBenchmark _benchmark;
 };
 
 #endif // FFQUEUEITEM_H
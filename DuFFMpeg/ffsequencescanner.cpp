@@ -0,0 +1,254 @@
+#include "ffsequencescanner.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+QString FFSequence::fileName() const
+{
+    return directory + "/" + prefix + "{" + QString(digits,'#') + "}" + suffix;
+}
+
+QList<int> FFSequence::missingNumbers() const
+{
+    QList<int> missing;
+    for (int i = 1 ; i < numbers.count() ; i++)
+    {
+        for (int n = numbers.at(i-1) + 1 ; n < numbers.at(i) ; n++) missing << n;
+    }
+    return missing;
+}
+
+QList<int> FFSequence::duplicateNumbers() const
+{
+    QList<int> duplicates;
+    for (int i = 1 ; i < numbers.count() ; i++)
+    {
+        if (numbers.at(i) != numbers.at(i-1)) continue;
+        if (duplicates.count() == 0 || duplicates.last() != numbers.at(i)) duplicates << numbers.at(i);
+    }
+    return duplicates;
+}
+
+FFSequenceScanner::FFSequenceScanner(QObject *parent) : FFObject(parent)
+{
+
+}
+
+QList<FFSequence> FFSequenceScanner::scan(QString directory, QString extension)
+{
+    //the sequences being built, by prefix and suffix
+    struct Group {
+        FFSequence sequence;
+        QList<QPair<int,QString>> frames;
+        int minDigits = 999;
+        bool padded = false;
+    };
+    QHash<QString, Group> groups;
+    QStringList keys;
+
+    foreach(QString name,listFiles(directory,extension))
+    {
+        //the frame number is the last group of digits before the extension
+        int dot = name.lastIndexOf('.');
+        if (dot < 0) dot = name.count();
+        QList<QPair<int,int>> blocks = digitBlocks(name.left(dot));
+        //limited to what fits in an int
+        if (blocks.count() == 0 || blocks.at(0).second - blocks.at(0).first > 9) continue;
+
+        int start = blocks.at(0).first;
+        int end = blocks.at(0).second;
+        QString prefix = name.left(start);
+        QString suffix = name.mid(end);
+        QString key = prefix + '/' + suffix;
+
+        if (!groups.contains(key))
+        {
+            Group group;
+            group.sequence.directory = directory;
+            group.sequence.prefix = prefix;
+            group.sequence.suffix = suffix;
+            groups.insert(key,group);
+            keys << key;
+        }
+        Group &group = groups[key];
+        int digits = end - start;
+        group.frames << QPair<int,QString>(name.midRef(start,digits).toInt(),name);
+        if (digits < group.minDigits) group.minDigits = digits;
+        if (digits > 1 && name.at(start) == '0') group.padded = true;
+    }
+
+    QList<FFSequence> sequences;
+    foreach(QString key,keys)
+    {
+        Group &group = groups[key];
+        finish(group.sequence,group.frames,group.minDigits,group.padded);
+        sequences << group.sequence;
+    }
+    return sequences;
+}
+
+FFSequence FFSequenceScanner::sequence(QString fileName)
+{
+    FFSequence sequence;
+    QFileInfo info(fileName);
+    QString name = info.fileName();
+    sequence.directory = info.path();
+
+    int dot = name.lastIndexOf('.');
+    if (dot < 0) dot = name.count();
+    QList<QPair<int,int>> blocks = digitBlocks(name.left(dot));
+    if (blocks.count() == 0) return sequence;
+
+    //usually the frame number is the last group of digits: the folder is grouped in one pass
+    if (blocks.at(0).second - blocks.at(0).first <= 9)
+    {
+        QString prefix = name.left(blocks.at(0).first);
+        QString suffix = name.mid(blocks.at(0).second);
+        foreach(FFSequence found,scan(sequence.directory,info.suffix()))
+        {
+            if (found.prefix != prefix || found.suffix != suffix) continue;
+            if (found.frames.count() > 1) return found;
+            //a single frame: keep it if no other group changes
+            sequence = found;
+            break;
+        }
+    }
+    if (blocks.count() == 1) return sequence;
+
+    QStringList names = listFiles(sequence.directory,info.suffix());
+
+    //try the previous groups of digits, until one changes between the files
+    for (int b = 1 ; b < blocks.count() ; b++)
+    {
+        int start = blocks.at(b).first;
+        int end = blocks.at(b).second;
+        if (end - start > 9) continue;
+        QString prefix = name.left(start);
+        QString suffix = name.mid(end);
+
+        QList<QPair<int,QString>> frames;
+        int minDigits = 999;
+        bool padded = false;
+        foreach(QString n,names)
+        {
+            int number = 0;
+            int digits = 0;
+            if (!frameNumber(n,prefix,suffix,number,digits)) continue;
+            frames << QPair<int,QString>(number,n);
+            if (digits < minDigits) minDigits = digits;
+            if (digits > 1 && n.at(start) == '0') padded = true;
+        }
+
+        FFSequence found;
+        found.directory = sequence.directory;
+        found.prefix = prefix;
+        found.suffix = suffix;
+        finish(found,frames,minDigits,padded);
+        if (frames.count() > 1) return found;
+    }
+
+    return sequence;
+}
+
+QList<QFileInfo> FFSequenceScanner::stat(const QStringList &files)
+{
+    //on network shares, the latency of each stat is hidden by running them in parallel
+    struct Stat {
+        typedef QFileInfo result_type;
+        QFileInfo operator()(const QString &file)
+        {
+            QFileInfo info(file);
+            //the result is cached by the info
+            info.exists();
+            return info;
+        }
+    };
+    return QtConcurrent::blockingMapped<QList<QFileInfo>>(files,Stat());
+}
+
+qint64 FFSequenceScanner::totalSize(const QStringList &files)
+{
+    qint64 total = 0;
+    foreach(QFileInfo info,stat(files)) total += info.size();
+    return total;
+}
+
+QStringList FFSequenceScanner::listFiles(QString directory, QString extension)
+{
+    QStringList names;
+    QString suffix = "";
+    if (extension != "") suffix = "." + extension;
+
+    //QDirIterator reads the entries one by one, the file type comes with the entry on most file systems
+    QDirIterator it(directory,QDir::Files | QDir::NoDotAndDotDot);
+    while (it.hasNext())
+    {
+        it.next();
+        QString name = it.fileName();
+        if (suffix != "" && !name.endsWith(suffix,Qt::CaseInsensitive)) continue;
+        names << name;
+    }
+    return names;
+}
+
+QList<QPair<int, int>> FFSequenceScanner::digitBlocks(const QString &name)
+{
+    QList<QPair<int,int>> blocks;
+    int end = -1;
+    for (int i = name.count() - 1 ; i >= 0 ; i--)
+    {
+        bool digit = isDigit(name.at(i));
+        if (digit && end < 0) end = i + 1;
+        else if (!digit && end >= 0)
+        {
+            blocks << QPair<int,int>(i + 1,end);
+            end = -1;
+        }
+    }
+    if (end >= 0) blocks << QPair<int,int>(0,end);
+    return blocks;
+}
+
+bool FFSequenceScanner::frameNumber(const QString &name, const QString &prefix, const QString &suffix, int &number, int &digits)
+{
+    digits = name.count() - prefix.count() - suffix.count();
+    if (digits <= 0 || digits > 9) return false;
+    if (!name.startsWith(prefix) || !name.endsWith(suffix)) return false;
+
+    number = 0;
+    for (int i = prefix.count() ; i < prefix.count() + digits ; i++)
+    {
+        QChar c = name.at(i);
+        if (!isDigit(c)) return false;
+        number = number * 10 + (c.unicode() - '0');
+    }
+    return true;
+}
+
+bool FFSequenceScanner::isDigit(const QChar &c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+void FFSequenceScanner::finish(FFSequence &sequence, QList<QPair<int, QString> > &frames, int minDigits, bool padded)
+{
+    std::sort(frames.begin(),frames.end());
+
+    sequence.digits = 1;
+    if (padded) sequence.digits = minDigits;
+    sequence.numbers.clear();
+    sequence.frames.clear();
+    sequence.numbers.reserve(frames.count());
+    sequence.frames.reserve(frames.count());
+    for (int i = 0 ; i < frames.count() ; i++)
+    {
+        sequence.numbers << frames.at(i).first;
+        sequence.frames << sequence.directory + "/" + frames.at(i).second;
+    }
+    if (frames.count() > 0)
+    {
+        sequence.startNumber = frames.first().first;
+        sequence.endNumber = frames.last().first;
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef FFSEQUENCESCANNER_H
+#define FFSEQUENCESCANNER_H
+
+#include "ffobject.h"
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QHash>
+#include <QStringList>
+#include <QtConcurrent>
+
+/**
+ * @brief The FFSequence struct An image sequence found in a folder: prefix + frame number + suffix
+ */
+struct FFSequence
+{
+    QString directory;
+    /**
+     * @brief prefix The part of the file names before the frame number
+     */
+    QString prefix;
+    /**
+     * @brief suffix The part of the file names after the frame number, with the extension
+     */
+    QString suffix;
+    /**
+     * @brief digits The number of digits of the frame numbers if they are zero-padded, 1 if they are not
+     */
+    int digits = 1;
+    int startNumber = 0;
+    int endNumber = 0;
+    /**
+     * @brief numbers The frame numbers, sorted
+     */
+    QList<int> numbers;
+    /**
+     * @brief frames The paths of the files, sorted by frame number
+     */
+    QStringList frames;
+    /**
+     * @brief fileName The name of the sequence with the {###} convention
+     */
+    QString fileName() const;
+    /**
+     * @brief missingNumbers The frame numbers missing between the start and the end of the sequence
+     */
+    QList<int> missingNumbers() const;
+    /**
+     * @brief duplicateNumbers The frame numbers found in several files (with a different padding)
+     */
+    QList<int> duplicateNumbers() const;
+};
+
+/**
+ * @brief The FFSequenceScanner class Finds the image sequences in a folder.
+ * The folder is read in a single pass with QDirIterator, which does not need to stat each file,
+ * the frame numbers are parsed without regular expressions, and the size of the files is only read when it's needed.
+ */
+class FFSequenceScanner : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFSequenceScanner(QObject *parent = nullptr);
+
+    /**
+     * @brief scan Groups all the files of a folder in sequences, in one pass
+     * @param directory The folder
+     * @param extension Only the files with this extension are listed, all files if empty
+     * @return The sequences, including the ones with a single frame
+     */
+    static QList<FFSequence> scan(QString directory, QString extension = "");
+    /**
+     * @brief sequence Finds the sequence a file belongs to.
+     * The frame number is the last group of digits of the name which changes between files of the folder.
+     * The folder is grouped with scan(), the other groups of digits are tried only if the last one does not change.
+     * @param fileName One of the frames
+     * @return The sequence, without frames if the name does not contain any number
+     */
+    static FFSequence sequence(QString fileName);
+    /**
+     * @brief stat Reads the information of the files in parallel
+     * @return The information, in the same order, already read: QFileInfo does not access the files again
+     */
+    static QList<QFileInfo> stat(const QStringList &files);
+    /**
+     * @brief totalSize Sums the size of the files, reading them in parallel
+     * @return The size in bytes
+     */
+    static qint64 totalSize(const QStringList &files);
+
+private:
+    /**
+     * @brief listFiles Lists the names of the files in a folder, with the given extension
+     */
+    static QStringList listFiles(QString directory, QString extension);
+    /**
+     * @brief digitBlocks Finds the groups of digits in a name
+     * @return The start and end positions of each group, from the last one to the first one
+     */
+    static QList<QPair<int,int>> digitBlocks(const QString &name);
+    /**
+     * @brief frameNumber Checks if a name is prefix + number + suffix
+     * @param number Set to the number if the name matches
+     * @param digits Set to the number of digits
+     * @return true if the name matches
+     */
+    static bool frameNumber(const QString &name, const QString &prefix, const QString &suffix, int &number, int &digits);
+    /**
+     * @brief isDigit A quick test for ASCII digits
+     */
+    static bool isDigit(const QChar &c);
+    /**
+     * @brief finish Sorts the frames and sets the numbers and padding of a sequence
+     * @param frames The frame numbers, their length, and the file names
+     */
+    static void finish(FFSequence &sequence, QList<QPair<int,QString>> &frames, int minDigits, bool padded);
+};
+
+#endif // FFSEQUENCESCANNER_H
@@ -0,0 +1,72 @@
+#include "ffstartupprofile.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+static bool profileEnabled = false;
+static QElapsedTimer profileTimer;
+static QString currentPhase = "";
+static qint64 currentPhaseStart = 0;
+static qint64 currentTraceStart = 0;
+static QStringList phaseNames;
+static QList<qint64> phaseDurations;
+
+FFStartupProfile::FFStartupProfile(QObject *parent) : FFObject(parent)
+{
+
+}
+
+bool FFStartupProfile::isEnabled()
+{
+    return profileEnabled;
+}
+
+void FFStartupProfile::setEnabled(bool enabled)
+{
+    profileEnabled = enabled;
+    if (enabled && !profileTimer.isValid()) profileTimer.start();
+}
+
+void FFStartupProfile::phase(QString name)
+{
+    if (!profileEnabled && !FFTrace::isEnabled()) return;
+
+    //end the current one
+    if (currentPhase != "")
+    {
+        if (profileEnabled)
+        {
+            phaseNames << currentPhase;
+            phaseDurations << profileTimer.elapsed() - currentPhaseStart;
+        }
+        FFTrace::span(currentPhase,"startup",0,currentTraceStart);
+    }
+
+    currentPhase = name;
+    if (profileEnabled) currentPhaseStart = profileTimer.elapsed();
+    currentTraceStart = FFTrace::now();
+}
+
+QString FFStartupProfile::finish()
+{
+    phase("");
+    if (!profileEnabled) return "";
+
+    QString report = "Startup profile:";
+    qint64 total = 0;
+    for (int i = 0 ; i < phaseNames.count() ; i++)
+    {
+        report += "\n" + phaseNames.at(i).leftJustified(24,' ') + QString::number(phaseDurations.at(i)).rightJustified(6,' ') + " ms";
+        total += phaseDurations.at(i);
+    }
+    report += "\n" + QString("Total").leftJustified(24,' ') + QString::number(total).rightJustified(6,' ') + " ms";
+
+    QTextStream out(stdout);
+    out << report << "\n";
+    out.flush();
+
+    phaseNames.clear();
+    phaseDurations.clear();
+    return report;
+}
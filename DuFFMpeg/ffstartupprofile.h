@@ -0,0 +1,37 @@
+#ifndef FFSTARTUPPROFILE_H
+#define FFSTARTUPPROFILE_H
+
+#include "ffobject.h"
+
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QStringList>
+
+#include "fftrace.h"
+
+/**
+ * @brief The FFStartupProfile class Measures the duration of each phase of the startup of the application.
+ * Enabled with the --startup-profile argument; the phases are then printed on the standard output when the startup is complete,
+ * and added to the trace if it is recorded (--trace).
+ */
+class FFStartupProfile : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFStartupProfile(QObject *parent = nullptr);
+
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+    /**
+     * @brief phase Ends the current phase and starts a new one
+     * @param name The name of the new phase
+     */
+    static void phase(QString name);
+    /**
+     * @brief finish Ends the current phase, the startup is complete
+     * @return The report of the phases, empty if the profile is not enabled
+     */
+    static QString finish();
+};
+
+#endif // FFSTARTUPPROFILE_H
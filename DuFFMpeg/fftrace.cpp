@@ -0,0 +1,162 @@
+#include "fftrace.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+//the events are kept in memory until the trace is exported: when the limit is reached, the new events are ignored
+static const int MAX_EVENTS = 1000000;
+
+static bool traceEnabled = false;
+static QMutex traceMutex;
+static QJsonArray traceEvents;
+static QMap<int, QString> traceTracks;
+
+static QElapsedTimer &traceTimer()
+{
+    static QElapsedTimer timer;
+    if (!timer.isValid()) timer.start();
+    return timer;
+}
+
+FFTrace::FFTrace(QObject *parent) : FFObject(parent)
+{
+
+}
+
+bool FFTrace::isEnabled()
+{
+    return traceEnabled;
+}
+
+void FFTrace::setEnabled(bool enabled)
+{
+    traceTimer();
+    traceEnabled = enabled;
+}
+
+qint64 FFTrace::now()
+{
+    return traceTimer().nsecsElapsed() / 1000;
+}
+
+void FFTrace::span(QString name, QString category, int track, qint64 start, QJsonObject args)
+{
+    if (!traceEnabled) return;
+    QJsonObject event;
+    event.insert("name",name);
+    event.insert("cat",category);
+    event.insert("ph","X");
+    event.insert("ts",start);
+    event.insert("dur",now() - start);
+    event.insert("tid",track);
+    if (!args.isEmpty()) event.insert("args",args);
+    addEvent(event);
+}
+
+void FFTrace::asyncSpan(QString name, QString category, qint64 id, qint64 start, QJsonObject args)
+{
+    if (!traceEnabled) return;
+    QJsonObject event;
+    event.insert("name",name);
+    event.insert("cat",category);
+    event.insert("id",QString::number(id));
+    event.insert("tid",0);
+
+    event.insert("ph","b");
+    event.insert("ts",start);
+    if (!args.isEmpty()) event.insert("args",args);
+    addEvent(event);
+
+    event.insert("ph","e");
+    event.insert("ts",now());
+    event.remove("args");
+    addEvent(event);
+}
+
+void FFTrace::instant(QString name, QString category, int track, QJsonObject args)
+{
+    if (!traceEnabled) return;
+    QJsonObject event;
+    event.insert("name",name);
+    event.insert("cat",category);
+    event.insert("ph","i");
+    event.insert("s","t");
+    event.insert("ts",now());
+    event.insert("tid",track);
+    if (!args.isEmpty()) event.insert("args",args);
+    addEvent(event);
+}
+
+void FFTrace::setTrackName(int track, QString name)
+{
+    QMutexLocker locker(&traceMutex);
+    traceTracks.insert(track,name);
+}
+
+QJsonObject FFTrace::toJson()
+{
+    QMutexLocker locker(&traceMutex);
+
+    QJsonArray events = traceEvents;
+    qint64 pid = QCoreApplication::applicationPid();
+
+    //metadata: the names of the process and the tracks
+    QJsonObject processName;
+    processName.insert("name","process_name");
+    processName.insert("ph","M");
+    processName.insert("pid",pid);
+    QJsonObject processArgs;
+    processArgs.insert("name",QCoreApplication::applicationName());
+    processName.insert("args",processArgs);
+    events.prepend(processName);
+
+    QMapIterator<int, QString> i(traceTracks);
+    while (i.hasNext())
+    {
+        i.next();
+        QJsonObject trackName;
+        trackName.insert("name","thread_name");
+        trackName.insert("ph","M");
+        trackName.insert("pid",pid);
+        trackName.insert("tid",i.key());
+        QJsonObject trackArgs;
+        trackArgs.insert("name",i.value());
+        trackName.insert("args",trackArgs);
+        events.prepend(trackName);
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents",events);
+    trace.insert("displayTimeUnit","ms");
+    return trace;
+}
+
+bool FFTrace::exportToFile(QString fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+#ifdef QT_DEBUG
+        qDebug() << "Cannot write the trace file" << fileName;
+#endif
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Compact));
+    file.close();
+    return true;
+}
+
+void FFTrace::clear()
+{
+    QMutexLocker locker(&traceMutex);
+    traceEvents = QJsonArray();
+}
+
+void FFTrace::addEvent(QJsonObject event)
+{
+    event.insert("pid",QCoreApplication::applicationPid());
+    QMutexLocker locker(&traceMutex);
+    if (traceEvents.count() >= MAX_EVENTS) return;
+    traceEvents.append(event);
+}
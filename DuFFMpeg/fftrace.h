@@ -0,0 +1,78 @@
+#ifndef FFTRACE_H
+#define FFTRACE_H
+
+#include "ffobject.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QMap>
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+/**
+ * @brief The FFTrace class Records the timeline of the queue and the encodings, in the Chrome Trace Event format,
+ * which can be opened in chrome://tracing or Perfetto.
+ * The trace is shared by the whole application and can be recorded from any thread. Nothing is recorded until it is enabled.
+ * Track 0 is the queue (launches, probes, sequence discovery), the other tracks are the worker slots, one per simultaneous encoding.
+ */
+class FFTrace : public FFObject
+{
+    Q_OBJECT
+public:
+    explicit FFTrace(QObject *parent = nullptr);
+
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+    /**
+     * @brief now The current time of the trace
+     * @return The time in microseconds since the application started
+     */
+    static qint64 now();
+    /**
+     * @brief span Records a span which ends now
+     * @param name The name of the span
+     * @param category The category, used to filter the spans in the viewer
+     * @param track The track (0 for the queue, the worker slot for the encodings)
+     * @param start The time the span started, from now()
+     * @param args Details shown when the span is selected
+     */
+    static void span(QString name, QString category, int track, qint64 start, QJsonObject args = QJsonObject());
+    /**
+     * @brief asyncSpan Records a span which can overlap other spans on the same track, like the time an item waits in the queue
+     * @param id Identifies the span, must be unique among the spans with the same name
+     */
+    static void asyncSpan(QString name, QString category, qint64 id, qint64 start, QJsonObject args = QJsonObject());
+    /**
+     * @brief instant Records an event without duration
+     */
+    static void instant(QString name, QString category, int track, QJsonObject args = QJsonObject());
+    /**
+     * @brief setTrackName Names a track in the viewer
+     */
+    static void setTrackName(int track, QString name);
+    /**
+     * @brief toJson Gets the trace in the Chrome Trace Event format
+     */
+    static QJsonObject toJson();
+    /**
+     * @brief exportToFile Writes the trace to a JSON file
+     * @return true if the file has been written
+     */
+    static bool exportToFile(QString fileName);
+    /**
+     * @brief clear Removes all the recorded events
+     */
+    static void clear();
+
+private:
+    /**
+     * @brief addEvent Adds an event, with the process id
+     */
+    static void addEvent(QJsonObject event);
+};
+
+#endif // FFTRACE_H
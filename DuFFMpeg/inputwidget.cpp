@@ -11,6 +11,8 @@ InputWidget::InputWidget(FFmpeg *ff, QWidget *parent) :
 
     ffmpeg = ff;
     _mediaInfo = new FFMediaInfo("",this);
+    _sizeWatcher = new QFutureWatcher<qint64>(this);
+    connect(_sizeWatcher,SIGNAL(finished()),this,SLOT(sizeLoaded()));
 
     updateOptions();
 }
@@ -40,8 +42,35 @@ void InputWidget::on_inputBrowseButton_clicked()
     QString inputPath = QFileDialog::getOpenFileName(this,"Select the media file to transcode",settings.value("input/path",QVariant("")).toString());
     if (inputPath == "") return;
 
-    _mediaInfo->updateInfo(ffmpeg->getMediaInfoString(inputPath));
+    //the header of the images is enough for sequences, FFmpeg is run only for the other medias
+    if (!_mediaInfo->loadImageSequence(inputPath)) _mediaInfo->updateInfo(ffmpeg->getMediaInfoString(inputPath));
 
+    //the frames of the sequence are read in the background
+    if (!_mediaInfo->hasSize()) _sizeWatcher->setFuture(QtConcurrent::run(FFSequenceScanner::totalSize,_mediaInfo->frames()));
+
+    updateMediaInfos();
+
+    //update UI
+    inputEdit->setText(QDir::toNativeSeparators(_mediaInfo->fileName()));
+    //keep in settings
+    QFileInfo fi(inputPath);
+    settings.setValue("input/path",QVariant(fi.path()));
+
+    updateOptions();
+
+    emit newMediaLoaded(_mediaInfo);
+}
+
+void InputWidget::sizeLoaded()
+{
+    //another media may have been loaded since
+    if (_mediaInfo->hasSize() || _sizeWatcher->isCanceled()) return;
+    _mediaInfo->setSize(_sizeWatcher->result());
+    updateMediaInfos();
+}
+
+void InputWidget::updateMediaInfos()
+{
     //Text
     QString mediaInfoString = "Media information";
 
@@ -57,13 +86,22 @@ void InputWidget::on_inputBrowseButton_clicked()
     {
         mediaInfoString += "\nDuration: " + QString::number(_mediaInfo->frames().count()) + " frames";
         mediaInfoString += "\nStart Frame Number: " + QString::number(_mediaInfo->startNumber());
+        //gaps make FFmpeg stop early
+        QList<int> missing = _mediaInfo->missingFrames();
+        if (missing.count() > 0) mediaInfoString += "\nMissing frames: " + QString::number(missing.count()) + " (" + frameNumbers(missing) + ")";
+        QList<int> duplicates = _mediaInfo->duplicateFrames();
+        if (duplicates.count() > 0) mediaInfoString += "\nDuplicate frames: " + QString::number(duplicates.count()) + " (" + frameNumbers(duplicates) + ")";
     }
 
 
-    double size = _mediaInfo->size(FFMediaInfo::MB);
-    int roundedSize = size*1000+0.5;
-    size = roundedSize/1000;
-    mediaInfoString += "\nSize: " + QString::number(size) + " MB";
+    if (_mediaInfo->hasSize())
+    {
+        double size = _mediaInfo->size(FFMediaInfo::MB);
+        int roundedSize = size*1000+0.5;
+        size = roundedSize/1000;
+        mediaInfoString += "\nSize: " + QString::number(size) + " MB";
+    }
+    else mediaInfoString += "\nSize: reading the frames...";
 
     mediaInfoString += "\nContains video: ";
     if (_mediaInfo->hasVideo()) mediaInfoString += "yes";
@@ -84,6 +122,8 @@ void InputWidget::on_inputBrowseButton_clicked()
         }
         mediaInfoString += "\nResolution: " + QString::number(_mediaInfo->videoWidth()) + "x" + QString::number(_mediaInfo->videoHeight());
         mediaInfoString += "\nFramerate: " + QString::number(_mediaInfo->videoFramerate()) + " fps";
+        if (_mediaInfo->bitDepth() > 0) mediaInfoString += "\nBit depth: " + QString::number(_mediaInfo->bitDepth()) + " bits per channel";
+        if (_mediaInfo->hasAlpha()) mediaInfoString += "\nAlpha: yes";
         int bitrate = _mediaInfo->videoBitrate(FFMediaInfo::Mbps);
         if (bitrate != 0) mediaInfoString += "\nBitrate: " + QString::number(bitrate) + " Mbps";
     }
@@ -103,16 +143,6 @@ void InputWidget::on_inputBrowseButton_clicked()
     //mediaInfoString += "\n\nFFmpeg analysis:\n" + _mediaInfo->ffmpegOutput();
 
     mediaInfosText->setText(mediaInfoString);
-
-    //update UI
-    inputEdit->setText(QDir::toNativeSeparators(_mediaInfo->fileName()));
-    //keep in settings
-    QFileInfo fi(inputPath);
-    settings.setValue("input/path",QVariant(fi.path()));
-
-    updateOptions();
-
-    emit newMediaLoaded(_mediaInfo);
 }
 
 void InputWidget::on_addParamButton_clicked()
@@ -165,6 +195,24 @@ void InputWidget::on_frameRateEdit_valueChanged(double arg1)
 
 }
 
+void InputWidget::on_holdFramesButton_toggled(bool checked)
+{
+    _mediaInfo->setHoldMissingFrames(checked);
+}
+
+void InputWidget::on_followButton_toggled(bool checked)
+{
+    _mediaInfo->setFollowSequence(checked);
+}
+
+QString InputWidget::frameNumbers(QList<int> numbers)
+{
+    QStringList list;
+    for (int i = 0 ; i < numbers.count() && i < 10 ; i++) list << QString::number(numbers.at(i));
+    if (numbers.count() > 10) list << "...";
+    return list.join(", ");
+}
+
 void InputWidget::updateOptions()
 {
     //frame rate
@@ -179,6 +227,15 @@ void InputWidget::updateOptions()
         frameRateEdit->show();
     }
 
+    //missing frames
+    holdFramesButton->setVisible(_mediaInfo->missingFrames().count() > 0);
+    //sequence being rendered
+    followButton->setVisible(_mediaInfo->isImageSequence());
+
     //uncheck what is hidden
     if (frameRateButton->isHidden()) frameRateButton->setChecked(false);
+    if (holdFramesButton->isHidden()) holdFramesButton->setChecked(false);
+    if (followButton->isHidden()) followButton->setChecked(false);
+    _mediaInfo->setHoldMissingFrames(holdFramesButton->isChecked());
+    _mediaInfo->setFollowSequence(followButton->isChecked());
 }
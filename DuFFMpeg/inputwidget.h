@@ -5,6 +5,8 @@
 
 #include <QFileDialog>
 #include <QSettings>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 #include "ffmpeg.h"
 
@@ -26,12 +28,30 @@ private slots:
     void on_frameRateButton_toggled(bool checked);
     void on_frameRateBox_activated(const QString &arg1);
     void on_frameRateEdit_valueChanged(double arg1);
+    void on_holdFramesButton_toggled(bool checked);
+    void on_followButton_toggled(bool checked);
+    /**
+     * @brief sizeLoaded Shows the size of the frames of a sequence, once they have been read
+     */
+    void sizeLoaded();
 private:
     FFmpeg *ffmpeg;
     FFMediaInfo *_mediaInfo;
     QList<QLineEdit *> _customParamEdits;
     QList<QLineEdit *> _customValueEdits;
+    /**
+     * @brief _sizeWatcher Reads the size of the frames of a sequence in the background, stat-ing them can be long on a network share
+     */
+    QFutureWatcher<qint64> *_sizeWatcher;
     void updateOptions();
+    /**
+     * @brief updateMediaInfos Shows the information of the current media
+     */
+    void updateMediaInfos();
+    /**
+     * @brief frameNumbers Lists the first frame numbers, to be shown to the user
+     */
+    QString frameNumbers(QList<int> numbers);
 };
 
 #endif // INPUTWIDGET_H
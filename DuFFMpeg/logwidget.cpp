@@ -0,0 +1,155 @@
+#include "logwidget.h"
+
+#ifdef QT_DEBUG
+#include <QtDebug>
+#endif
+
+LogWidget::LogWidget(QWidget *parent) :
+    QWidget(parent)
+{
+    setupUi(this);
+
+    _maximumLines = logEdit->maximumBlockCount();
+    _dirty = false;
+
+    _flushTimer = new QTimer(this);
+    _flushTimer->setSingleShot(true);
+    _flushTimer->setInterval(100);
+    connect(_flushTimer,SIGNAL(timeout()),this,SLOT(flush()));
+}
+
+void LogWidget::setSourceFilterVisible(bool visible)
+{
+    sourceBox->setVisible(visible);
+}
+
+void LogWidget::setLevelFilterVisible(bool visible)
+{
+    levelBox->setVisible(visible);
+}
+
+void LogWidget::setMaximumLines(int maximum)
+{
+    _maximumLines = maximum;
+    logEdit->setMaximumBlockCount(maximum);
+    while (_entries.count() > _maximumLines) removeFirst();
+}
+
+void LogWidget::log(QString text, Level level, QString source)
+{
+    //add date
+    QString time = QTime::currentTime().toString("[hh:mm:ss.zzz]: ");
+
+    if (source != "" && !_sources.contains(source) && sourceBox->findText(source) < 0) sourceBox->addItem(source);
+
+    QStringList lines = text.split("\n");
+    //a final line feed does not add an empty line
+    if (lines.count() > 1 && lines.last() == "") lines.removeLast();
+
+    foreach(QString line,lines)
+    {
+        Entry entry;
+        entry.text = time + line;
+        entry.level = level;
+        entry.source = source;
+        _entries << entry;
+        if (source != "") _sources[source]++;
+        if (_entries.count() > _maximumLines) removeFirst();
+
+        //the view is rendered again when it is shown
+        if (!isVisible()) _dirty = true;
+        if (_dirty) continue;
+
+        if (accept(entry)) _pending << entry.text;
+    }
+
+    if (_pending.count() > 0 && !_flushTimer->isActive()) _flushTimer->start();
+}
+
+void LogWidget::clear()
+{
+    while (_entries.count() > 0) removeFirst();
+    _pending.clear();
+    _dirty = false;
+    logEdit->clear();
+}
+
+void LogWidget::showEvent(QShowEvent *event)
+{
+    if (_dirty) render();
+    QWidget::showEvent(event);
+}
+
+void LogWidget::flush()
+{
+    if (_pending.count() == 0) return;
+
+    //follow the end of the log, unless the user has scrolled up
+    QScrollBar *scrollBar = logEdit->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    logEdit->appendPlainText(_pending.join("\n"));
+    _pending.clear();
+
+    if (atBottom) scrollBar->setValue(scrollBar->maximum());
+}
+
+void LogWidget::on_sourceBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    //the previous selection may not have any entry left
+    sourceBox->blockSignals(true);
+    for (int i = sourceBox->count() - 1 ; i > 0 ; i--)
+    {
+        if (i != sourceBox->currentIndex() && !_sources.contains(sourceBox->itemText(i))) sourceBox->removeItem(i);
+    }
+    sourceBox->blockSignals(false);
+    render();
+}
+
+void LogWidget::on_levelBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    render();
+}
+
+void LogWidget::on_clearButton_clicked()
+{
+    clear();
+}
+
+bool LogWidget::accept(const Entry &entry)
+{
+    if (entry.level < levelBox->currentIndex()) return false;
+    if (sourceBox->currentIndex() > 0 && entry.source != sourceBox->currentText()) return false;
+    return true;
+}
+
+void LogWidget::removeFirst()
+{
+    QString source = _entries.takeFirst().source;
+    if (source == "") return;
+    _sources[source]--;
+    if (_sources.value(source) > 0) return;
+    _sources.remove(source);
+    //the selected source stays until another one is selected
+    if (sourceBox->currentText() == source) return;
+    int index = sourceBox->findText(source);
+    if (index > 0) sourceBox->removeItem(index);
+}
+
+void LogWidget::render()
+{
+    _pending.clear();
+    _dirty = false;
+
+    QStringList lines;
+    foreach(Entry entry,_entries)
+    {
+        if (accept(entry)) lines << entry.text;
+    }
+    logEdit->setPlainText(lines.join("\n"));
+
+    QScrollBar *scrollBar = logEdit->verticalScrollBar();
+    scrollBar->setValue(scrollBar->maximum());
+}
@@ -0,0 +1,105 @@
+#ifndef LOGWIDGET_H
+#define LOGWIDGET_H
+
+#include "ui_logwidget.h"
+
+#include <QTime>
+#include <QTimer>
+#include <QScrollBar>
+#include <QHash>
+
+/**
+ * @brief The LogWidget class Shows a log, filtered by source and by level.
+ * The number of lines kept is bounded, new lines are appended by batches,
+ * and nothing is rendered while the widget is hidden: the cost of a new line does not depend on the size of the log.
+ */
+class LogWidget : public QWidget, private Ui::LogWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief The Level enum The level of the messages
+     */
+    enum Level { Information, Warning, Critical, Fatal };
+    Q_ENUM(Level)
+
+    explicit LogWidget(QWidget *parent = 0);
+
+    /**
+     * @brief setSourceFilterVisible Shows or hides the source selector
+     */
+    void setSourceFilterVisible(bool visible);
+    /**
+     * @brief setLevelFilterVisible Shows or hides the level selector
+     */
+    void setLevelFilterVisible(bool visible);
+    /**
+     * @brief setMaximumLines Sets the number of lines kept in the log
+     */
+    void setMaximumLines(int maximum);
+
+public slots:
+    /**
+     * @brief log Adds a message to the log
+     * @param text The message, which can contain several lines
+     * @param level The level of the message
+     * @param source The name of the source of the message (the encoding), an empty string for a general message
+     */
+    void log(QString text, Level level = Information, QString source = "");
+    void clear();
+
+protected:
+    void showEvent(QShowEvent *event);
+
+private slots:
+    /**
+     * @brief flush Appends the pending lines to the view
+     */
+    void flush();
+    void on_sourceBox_currentIndexChanged(int index);
+    void on_levelBox_currentIndexChanged(int index);
+    void on_clearButton_clicked();
+
+private:
+    /**
+     * @brief The Entry struct A line of the log
+     */
+    struct Entry {
+        QString text;
+        Level level;
+        QString source;
+    };
+    /**
+     * @brief _entries The latest lines, at most _maximumLines
+     */
+    QList<Entry> _entries;
+    int _maximumLines;
+    /**
+     * @brief _sources The number of entries of each source, the sources without entries are removed from the selector
+     */
+    QHash<QString, int> _sources;
+    /**
+     * @brief _pending The lines to append to the view at the next flush
+     */
+    QStringList _pending;
+    /**
+     * @brief _dirty True when the view has to be rendered again from the entries
+     */
+    bool _dirty;
+    QTimer *_flushTimer;
+    /**
+     * @brief accept Checks if a line passes the current filters
+     */
+    bool accept(const Entry &entry);
+    /**
+     * @brief removeFirst Removes the oldest entry, and its source from the selector if it was the last one of this source
+     */
+    void removeFirst();
+    /**
+     * @brief render Renders all the entries again
+     */
+    void render();
+};
+
+#endif // LOGWIDGET_H
@@ -6,11 +6,33 @@
 #include <QSettings>
 
 #include "ffmpeg.h"
+#include "ffstartupprofile.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    //parsers microbenchmarks on a recorded FFmpeg output, one is in Test Medias/FFmpeg outputs
+    int benchmarkIndex = a.arguments().indexOf("--benchmark-parsers");
+    if (benchmarkIndex >= 0 && benchmarkIndex + 1 < a.arguments().count())
+    {
+        return FFOutputParser::benchmark(a.arguments().at(benchmarkIndex + 1));
+    }
+
+    //timeline of the queue and the encodings, written when the application quits
+    QString traceFileName = "";
+    int traceIndex = a.arguments().indexOf("--trace");
+    if (traceIndex >= 0 && traceIndex + 1 < a.arguments().count())
+    {
+        traceFileName = a.arguments().at(traceIndex + 1);
+        FFTrace::setEnabled(true);
+    }
+
+    //duration of each phase of the startup, printed when the main window is ready
+    if (a.arguments().contains("--startup-profile")) FFStartupProfile::setEnabled(true);
+
+    FFStartupProfile::phase("Splash screen");
+
     //create splash screen
     QPixmap pixmap(":/images/splash");
     QSplashScreen splash(pixmap);
@@ -24,6 +46,7 @@ int main(int argc, char *argv[])
     message += APPVERSION;
     message += " | ";
     splash.showMessage(message + "Loading settings...");
+    FFStartupProfile::phase("Settings");
     QCoreApplication::setOrganizationName("Duduf");
     QCoreApplication::setOrganizationDomain("duduf.com");
     QCoreApplication::setApplicationName("DuFFmpeg");
@@ -32,6 +55,7 @@ int main(int argc, char *argv[])
 
     //load FFmpeg
     splash.showMessage(message + "Initializing FFmpeg...");
+    FFStartupProfile::phase("FFmpeg (codecs, muxers)");
     //TODO auto find ffmpeg if no settings or path invalid
     //then save to settings
     FFmpeg *ffmpeg = new FFmpeg(settings.value("ffmpeg/path","ffmpeg.exe").toString());
@@ -41,10 +65,13 @@ int main(int argc, char *argv[])
     splash.showMessage(message + "Building UI");
     MainWindow *w = new MainWindow(ffmpeg);
     FrameLess f(w);
+    FFStartupProfile::phase("Show main window");
     w->show();
     //hide splash when finished
     splash.finish(w);
 
     //end appli
-    return a.exec();
+    int result = a.exec();
+    if (traceFileName != "") FFTrace::exportToFile(traceFileName);
+    return result;
 }
@@ -7,7 +7,20 @@
 MainWindow::MainWindow(FFmpeg *ff, QWidget *parent) :
     QMainWindow(parent)
 {
+    FFStartupProfile::phase("Main window: setup UI");
     setupUi(this);
+
+    //logs
+    consoleWidget = new LogWidget(this);
+    consoleWidget->setLevelFilterVisible(false);
+    verticalLayout->insertWidget(0,consoleWidget);
+    debugWidget = new LogWidget(this);
+    debugWidget->setSourceFilterVisible(false);
+    verticalLayout_3->addWidget(debugWidget);
+    //metrics
+    metricsSparkline = new SparklineWidget(this);
+    horizontalLayout_6->insertWidget(1,metricsSparkline);
+
     debugLog("Initialization");
 
     // === SETTINGS ===
@@ -21,14 +34,31 @@ MainWindow::MainWindow(FFmpeg *ff, QWidget *parent) :
 
     // === FFMPEG INIT ===
     debugLog("Init - FFmpeg");
+    FFStartupProfile::phase("Main window: FFmpeg settings");
     //TODO auto find ffmpeg if no settings or path invalid
     //then save to settings
     ffmpeg = ff;
+    ffmpeg->setMaxRunningJobs(settings->value("ffmpeg/maxJobs",1).toInt());
+    ffmpeg->setMemoryBudget(settings->value("ffmpeg/memoryBudget",0).toLongLong()*1024*1024);
+    ffmpeg->setOutputBufferSize(settings->value("ffmpeg/outputBuffer",1024).toInt()*1024);
+    ffmpeg->setJobLogsPath(settings->value("ffmpeg/logsPath","").toString());
+    ffmpeg->setProgressRate(settings->value("ffmpeg/progressRate",8).toInt());
+    ffmpeg->setLogsMaxSize(settings->value("ffmpeg/logsMaxSize",10).toLongLong()*1024*1024);
+    ffmpeg->setMetricsPort(settings->value("ffmpeg/metricsPort",0).toInt());
+    ffmpeg->setBenchmarkEnabled(settings->value("ffmpeg/benchmark",false).toBool());
+    ffmpeg->setFollowCompletion(settings->value("ffmpeg/followCompletion",0).toInt());
+    ffmpeg->setFollowTimeout(settings->value("ffmpeg/followTimeout",60).toInt());
+    ffmpeg->setPrefetchThreads(settings->value("ffmpeg/prefetchThreads",0).toInt());
+    ffmpeg->setPrefetchDepth(settings->value("ffmpeg/prefetchDepth",16).toInt());
+    ffmpeg->setCacheBudget(settings->value("ffmpeg/cacheBudget",0).toLongLong()*1024*1024);
+    ffmpeg->setBatchProcesses(settings->value("ffmpeg/batchProcesses",1).toInt());
+    ffmpeg->setMezzaninePath(settings->value("ffmpeg/mezzaninePath","").toString());
 
 
     // === UI SETUP ===
 
     debugLog("Init - UI");
+    FFStartupProfile::phase("Main window: toolbar");
     //remove right click on toolbar
     mainToolBar->setContextMenuPolicy(Qt::PreventContextMenu);
     //populate toolbar
@@ -51,15 +81,19 @@ MainWindow::MainWindow(FFmpeg *ff, QWidget *parent) :
     mainToolBar->installEventFilter(this);
 
     //settings widget
+    FFStartupProfile::phase("Main window: settings widget");
     settingsWidget = new SettingsWidget(settings,this);
     settingsPage->layout()->addWidget(settingsWidget);
 
-    //queue widget
+    //queue widget (codecs, muxers and presets lists)
+    FFStartupProfile::phase("Main window: queue widget");
     queueWidget = new QueueWidget(ffmpeg,this);
     queueLayout->addWidget(queueWidget);
 
     //set style
+    FFStartupProfile::phase("Main window: CSS");
     updateCSS(":/styles/default");
+    FFStartupProfile::phase("Main window: restore state");
 
     //init UI
     consoleTabs->setCurrentIndex(3);
@@ -100,6 +134,7 @@ MainWindow::MainWindow(FFmpeg *ff, QWidget *parent) :
     qDebug() << "Init - Map Events";
 #endif
     debugLog("Init - Map events");
+    FFStartupProfile::phase("Main window: map events");
     // Window management
 #ifndef Q_OS_MAC
     // Windows and linux
@@ -109,23 +144,56 @@ MainWindow::MainWindow(FFmpeg *ff, QWidget *parent) :
     connect(quitButton,SIGNAL(clicked()),this,SLOT(close()));
     //FFmpeg
     connect(ffmpeg,SIGNAL(newOutput(QString)),this,SLOT(console(QString)));
+    connect(ffmpeg,SIGNAL(newJobOutput(FFQueueItem*,QString)),this,SLOT(ffmpeg_jobOutput(FFQueueItem*,QString)));
     connect(ffmpeg,SIGNAL(processError(QString)),this,SLOT(ffmpeg_errorOccurred(QString)));
     connect(ffmpeg,SIGNAL(encodingStarted(FFQueueItem*)),this,SLOT(ffmpeg_started(FFQueueItem*)));
     connect(ffmpeg,SIGNAL(encodingFinished(FFQueueItem*)),this,SLOT(ffmpeg_finished(FFQueueItem*)));
     connect(ffmpeg,SIGNAL(statusChanged(FFmpeg::Status)),this,SLOT(ffmpeg_statusChanged(FFmpeg::Status)));
+    connect(ffmpeg,SIGNAL(stopped()),this,SLOT(ffmpeg_stopped()));
     connect(ffmpeg,SIGNAL(progress()),this,SLOT(ffmpeg_progress()));
+    connect(ffmpeg,SIGNAL(telemetry()),this,SLOT(ffmpeg_telemetry()));
     connect(ffmpeg,SIGNAL(binaryChanged()),this,SLOT(ffmpeg_init()));
     connect(ffmpeg,SIGNAL(debugInfo(QString)),this,SLOT(ffmpeg_debugLog(QString)));
+    connect(ffmpeg,SIGNAL(longHelpLoaded(QString)),this,SLOT(loadHelp(QString)));
     //settings
     connect(settingsWidget,SIGNAL(ffmpegPathChanged(QString)),ffmpeg,SLOT(setBinaryFileName(QString)));
     connect(settingsWidget,SIGNAL(presetsPathChanged(QString)),queueWidget,SLOT(presetsPathChanged(QString)));
+    connect(settingsWidget,SIGNAL(maxJobsChanged(int)),ffmpeg,SLOT(setMaxRunningJobs(int)));
+    connect(settingsWidget,SIGNAL(memoryBudgetChanged(qint64)),ffmpeg,SLOT(setMemoryBudget(qint64)));
+    connect(settingsWidget,SIGNAL(outputBufferSizeChanged(int)),ffmpeg,SLOT(setOutputBufferSize(int)));
+    connect(settingsWidget,SIGNAL(jobLogsPathChanged(QString)),ffmpeg,SLOT(setJobLogsPath(QString)));
+    connect(settingsWidget,SIGNAL(progressRateChanged(int)),ffmpeg,SLOT(setProgressRate(int)));
+    connect(settingsWidget,SIGNAL(logsMaxSizeChanged(qint64)),ffmpeg,SLOT(setLogsMaxSize(qint64)));
+    connect(settingsWidget,SIGNAL(metricsPortChanged(int)),ffmpeg,SLOT(setMetricsPort(int)));
+    connect(settingsWidget,SIGNAL(benchmarkChanged(bool)),ffmpeg,SLOT(setBenchmarkEnabled(bool)));
+    connect(settingsWidget,SIGNAL(followCompletionChanged(int)),ffmpeg,SLOT(setFollowCompletion(int)));
+    connect(settingsWidget,SIGNAL(followTimeoutChanged(int)),ffmpeg,SLOT(setFollowTimeout(int)));
+    connect(settingsWidget,SIGNAL(prefetchThreadsChanged(int)),ffmpeg,SLOT(setPrefetchThreads(int)));
+    connect(settingsWidget,SIGNAL(prefetchDepthChanged(int)),ffmpeg,SLOT(setPrefetchDepth(int)));
+    connect(settingsWidget,SIGNAL(cacheBudgetChanged(qint64)),ffmpeg,SLOT(setCacheBudget(qint64)));
+    connect(settingsWidget,SIGNAL(batchProcessesChanged(int)),ffmpeg,SLOT(setBatchProcesses(int)));
+    connect(settingsWidget,SIGNAL(mezzaninePathChanged(QString)),ffmpeg,SLOT(setMezzaninePath(QString)));
+
+    //once the window is shown
+    QTimer::singleShot(0,this,SLOT(startupFinished()));
 }
 
 void MainWindow::ffmpeg_init()
 {
-    //get help
-    helpEdit->setText(ffmpeg->getLongHelp());
     queuePage->setEnabled(true);
+    //the help is not needed to start, it is loaded in the background and shown when it's ready
+    ffmpeg->loadLongHelp();
+}
+
+void MainWindow::loadHelp(QString help)
+{
+    helpEdit->setText(help);
+}
+
+void MainWindow::startupFinished()
+{
+    QString report = FFStartupProfile::finish();
+    if (report != "") debugLog(report);
 }
 
 void MainWindow::ffmpeg_debugLog(QString log)
@@ -133,6 +201,14 @@ void MainWindow::ffmpeg_debugLog(QString log)
     debugLog("FFmpeg: " + log);
 }
 
+void MainWindow::ffmpeg_jobOutput(FFQueueItem *item, QString output)
+{
+    //the encodings are identified by their first output
+    QString source = "Encoding";
+    if (item->getOutputMedias().count() > 0) source = QFileInfo(item->getOutputMedias()[0]->fileName()).fileName();
+    consoleWidget->log(output,LogWidget::Information,source);
+}
+
 void MainWindow::ffmpeg_errorOccurred(QString e)
 {
     debugLog("FFmpeg error: " + e,Warning);
@@ -157,7 +233,14 @@ void MainWindow::ffmpeg_started(FFQueueItem *item)
             currentEncodingNameLabel->setText(inputFile.fileName());
             float duration = 0.0;
             if (input->duration() > 0) progressBar->setMaximum(input->duration() * input->videoFramerate());
-            else if (input->isImageSequence()) progressBar->setMaximum(input->frames().count());
+            else if (input->isImageSequence())
+            {
+                int frames = input->frames().count() - input->duplicateFrames().count();
+                if (input->holdMissingFrames()) frames += input->missingFrames().count();
+                //the length of a followed sequence is not known yet
+                if (input->followSequence()) frames = 0;
+                progressBar->setMaximum(frames);
+            }
 
             break;
         }
@@ -194,6 +277,11 @@ void MainWindow::ffmpeg_statusChanged(FFmpeg::Status status)
     }
 }
 
+void MainWindow::ffmpeg_stopped()
+{
+    mainStatusBar->showMessage("Transcoding stopped.");
+}
+
 void MainWindow::ffmpeg_progress()
 {
 #ifdef QT_DEBUG
@@ -219,31 +307,44 @@ void MainWindow::ffmpeg_progress()
     timeRemainingLabel->setText(remaining.toString("hh:mm:ss"));
     //progress bar
     progressBar->setValue(ffmpeg->getCurrentFrame());
+    //other items
+    int running = ffmpeg->getRunningItems().count();
+    if (running > 1) statusLabel->setText("Transcoding " + QString::number(running) + " items...");
+}
+
+void MainWindow::ffmpeg_telemetry()
+{
+    FFQueueItem *item = ffmpeg->getCurrentItem();
+    if (item == nullptr) return;
+    updateMetrics();
+    FFProcessSample sample = item->processSample();
+    if (!sample.valid) return;
+    cpuLabel->setText(QString::number(sample.cpuUsage,'f',0) + "%");
+    memoryLabel->setText(QString::number(sample.memory / 1024 / 1024) + " MB (peak " + QString::number(item->peakMemory() / 1024 / 1024) + " MB)");
+    ioLabel->setText(QString::number(sample.readBytes / 1024 / 1024) + " MB read / " + QString::number(sample.writtenBytes / 1024 / 1024) + " MB written");
+}
+
+void MainWindow::updateMetrics()
+{
+    FFQueueItem *item = ffmpeg->getCurrentItem();
+    if (item == nullptr) return;
+    metricsSparkline->setValues(item->metrics()->values(FFMetrics::Metric(metricsBox->currentIndex())));
 }
 
 void MainWindow::console(QString log)
 {
-    //add date
-    QTime currentTime = QTime::currentTime();
-    //log
-    consoleEdit->setText(consoleEdit->toPlainText() + "\n" + currentTime.toString("[hh:mm:ss.zzz]: ") + log);
-    // put the slider at the bottom
-    consoleEdit->verticalScrollBar()->setSliderPosition(consoleEdit->verticalScrollBar()->maximum());
+    consoleWidget->log(log);
 }
 
 void MainWindow::debugLog(QString log, ErrorType type)
 {
-    //add date
-    QTime currentTime = QTime::currentTime();
     //type
     QString typeString = "";
     if (type == Warning) typeString = "/!\\ Warning: ";
     else if (type == Critical) typeString = " --- !!! Critical: ";
     else if (type == Fatal) typeString = " === Fatal === ";
     //log
-    debugEdit->setText(debugEdit->toPlainText() + "\n" + currentTime.toString("[hh:mm:ss.zzz]: ") + typeString + log);
-    // put the slider at the bottom
-    debugEdit->verticalScrollBar()->setSliderPosition(debugEdit->verticalScrollBar()->maximum());
+    debugWidget->log(typeString + log,LogWidget::Level(type));
 #ifdef QT_DEBUG
     qDebug() << typeString << log;
 #endif
@@ -261,22 +362,48 @@ void MainWindow::on_ffmpegCommandsButton_clicked()
     ffmpeg->runCommand(commands);
 }
 
+void MainWindow::on_metricsBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    updateMetrics();
+}
+
+void MainWindow::on_exportMetricsButton_clicked()
+{
+    FFQueueItem *item = ffmpeg->getCurrentItem();
+    if (item == nullptr || item->metrics()->count() == 0)
+    {
+        debugLog("There are no metrics to export yet",Warning);
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(this,"Export metrics",settings->value("metrics/path",QDir::homePath()).toString(),"CSV (*.csv);;JSON (*.json)");
+    if (fileName == "") return;
+    settings->setValue("metrics/path",QFileInfo(fileName).path());
+    if (!item->metrics()->exportToFile(fileName)) debugLog("Cannot write the metrics to " + fileName,Warning);
+}
+
 void MainWindow::on_actionGo_triggered()
 {
     //generate input and output
     FFMediaInfo *input = queueWidget->getInputMedia();
     QList<FFMediaInfo *> output = queueWidget->getOutputMedia();
 
+    FFQueueItem *item = new FFQueueItem(input,output,ffmpeg);
+    //profile only this one
+    item->setBenchmarkEnabled(actionProfile->isChecked());
+
     //Launch!
     debugLog("=== Beginning encoding ===");
-    ffmpeg->encode(input,output);
+    ffmpeg->encode(item);
 }
 
 void MainWindow::on_actionStop_triggered()
 {
-    mainStatusBar->showMessage("Stopping current transcoding...");
     //TODO ask for confirmation
-    ffmpeg->stop(6000);
+    if (ffmpeg->getRunningItems().count() == 0) return;
+    //does not wait for the processes, ffmpeg_stopped is called when they've finished
+    ffmpeg->stop(3000);
+    mainStatusBar->showMessage("Stopping current transcoding...");
 }
 
 void MainWindow::on_actionSettings_triggered(bool checked)
@@ -316,6 +443,10 @@ void MainWindow::reInitCurrentProgress()
     timeLabel->setText("00:00:00");
     timeRemainingLabel->setText("00:00:00");
     speedLabel->setText("0x");
+    cpuLabel->setText("0%");
+    memoryLabel->setText("0 MB");
+    ioLabel->setText("0 MB read / 0 MB written");
+    metricsSparkline->clear();
     currentEncodingNameLabel->setText("");
     progressBar->setMaximum(100);
     progressBar->setValue(0);
@@ -11,12 +11,16 @@
 #include <QMouseEvent>
 #include <QSettings>
 #include <QDateTime>
+#include <QTimer>
 
 #include "toolbarspacer.h"
 #include "settingswidget.h"
 #include "ffmpeg.h"
 #include "queuewidget.h"
 #include "rainboxui.h"
+#include "logwidget.h"
+#include "sparklinewidget.h"
+#include "ffstartupprofile.h"
 
 class MainWindow : public QMainWindow, private Ui::MainWindow
 {
@@ -37,16 +41,32 @@ private slots:
     void ffmpeg_started(FFQueueItem *item);
     void ffmpeg_finished(FFQueueItem *item);
     void ffmpeg_statusChanged(FFmpeg::Status status);
+    void ffmpeg_stopped();
     void ffmpeg_progress();
+    /**
+     * @brief ffmpeg_telemetry Shows the resources used by the current encoding
+     */
+    void ffmpeg_telemetry();
     /**
      * @brief ffmpeg_init Set FFmpeg binary path (using settings) and get help
      */
     void ffmpeg_init();
+    /**
+     * @brief loadHelp Shows the help of FFmpeg, which is loaded in the background
+     */
+    void loadHelp(QString help);
+    /**
+     * @brief startupFinished Called when the window has been shown and the deferred initialization is done
+     */
+    void startupFinished();
     void ffmpeg_debugLog(QString log);
+    void ffmpeg_jobOutput(FFQueueItem *item, QString output);
 
     // UI EVENTS
     void on_ffmpegCommandsEdit_returnPressed();
     void on_ffmpegCommandsButton_clicked();
+    void on_metricsBox_currentIndexChanged(int index);
+    void on_exportMetricsButton_clicked();
 
     // CONSOLE
     void console(QString log);
@@ -68,6 +88,22 @@ private:
     // ====== UI ========
 
     QueueWidget *queueWidget;
+    /**
+     * @brief consoleWidget The output of FFmpeg, which can be filtered by encoding
+     */
+    LogWidget *consoleWidget;
+    /**
+     * @brief debugWidget The debug log, which can be filtered by level
+     */
+    LogWidget *debugWidget;
+    /**
+     * @brief metricsSparkline The metric selected in metricsBox, since the current encoding started
+     */
+    SparklineWidget *metricsSparkline;
+    /**
+     * @brief updateMetrics Shows the metrics of the current encoding in the sparkline
+     */
+    void updateMetrics();
     void updateCSS(QString cssFileName);
     /**
      * @brief reInitCurrentProgress Initializes the current progress bar and infos
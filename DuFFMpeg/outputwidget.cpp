@@ -31,6 +31,23 @@ OutputWidget::OutputWidget(FFmpeg *ff, int id, QWidget *parent) :
     samplingBox->addItem("96,000 Hz",QVariant(96000));
     samplingBox->setCurrentIndex(6);
 
+    //populate image options
+    predictionBox->addItem("None",QVariant("none"));
+    predictionBox->addItem("Sub",QVariant("sub"));
+    predictionBox->addItem("Up",QVariant("up"));
+    predictionBox->addItem("Average",QVariant("avg"));
+    predictionBox->addItem("Paeth",QVariant("paeth"));
+    predictionBox->addItem("Mixed",QVariant("mixed"));
+    compressionMethodBox->addItem("None (raw)",QVariant("raw"));
+    compressionMethodBox->addItem("PackBits",QVariant("packbits"));
+    compressionMethodBox->addItem("LZW",QVariant("lzw"));
+    compressionMethodBox->addItem("Deflate",QVariant("deflate"));
+    packingBox->addItem("8 bits",QVariant("rgb24"));
+    packingBox->addItem("10 bits (packed)",QVariant("gbrp10"));
+    packingBox->addItem("12 bits",QVariant("gbrp12"));
+    packingBox->addItem("16 bits",QVariant("rgb48"));
+    packingBox->setCurrentIndex(1);
+
     ffmpeg_init();
 
     connect(_ffmpeg,SIGNAL(binaryChanged()),this,SLOT(ffmpeg_init()));
@@ -59,6 +76,11 @@ void OutputWidget::init()
     videoLoopsButton->setChecked(false);
     videoProfileButton->setChecked(false);
     videoQualityButton->setChecked(false);
+    segmentsButton->setChecked(false);
+    compressionButton->setChecked(false);
+    predictionButton->setChecked(false);
+    compressionMethodButton->setChecked(false);
+    packingButton->setChecked(false);
 
     //audio
     audioTranscodeButton->setChecked(true);
@@ -112,6 +134,26 @@ FFMediaInfo *OutputWidget::getMediaInfo()
             {
                 _mediaInfo->setStartNumber(startNumberEdit->value());
             }
+            if (segmentsButton->isChecked())
+            {
+                _mediaInfo->setSegmentLength(segmentsEdit->value());
+            }
+            if (compressionButton->isChecked())
+            {
+                _mediaInfo->setCompressionLevel(compressionEdit->value());
+            }
+            if (predictionButton->isChecked())
+            {
+                _mediaInfo->setPrediction(predictionBox->currentData().toString());
+            }
+            if (compressionMethodButton->isChecked())
+            {
+                _mediaInfo->setCompressionMethod(compressionMethodBox->currentData().toString());
+            }
+            if (packingButton->isChecked())
+            {
+                _mediaInfo->setPixelFormat(packingBox->currentData().toString());
+            }
         }
     }
 
@@ -235,6 +277,36 @@ void OutputWidget::setMediaInfo(FFMediaInfo *mediaInfo)
             videoProfileButton->setChecked(true);
             videoProfileBox->setCurrentIndex(profile);
         }
+        int segmentLength = _mediaInfo->segmentLength();
+        if (segmentLength > 0)
+        {
+            segmentsButton->setChecked(true);
+            segmentsEdit->setValue(segmentLength);
+        }
+        int compressionLevel = _mediaInfo->compressionLevel();
+        if (compressionLevel > -1)
+        {
+            compressionButton->setChecked(true);
+            compressionEdit->setValue(compressionLevel);
+        }
+        int prediction = predictionBox->findData(_mediaInfo->prediction());
+        if (prediction > -1)
+        {
+            predictionButton->setChecked(true);
+            predictionBox->setCurrentIndex(prediction);
+        }
+        int compressionMethod = compressionMethodBox->findData(_mediaInfo->compressionMethod());
+        if (compressionMethod > -1)
+        {
+            compressionMethodButton->setChecked(true);
+            compressionMethodBox->setCurrentIndex(compressionMethod);
+        }
+        int packing = packingBox->findData(_mediaInfo->pixelFormat());
+        if (packing > -1)
+        {
+            packingButton->setChecked(true);
+            packingBox->setCurrentIndex(packing);
+        }
     }
     else
     {
@@ -467,6 +539,42 @@ void OutputWidget::on_startNumberButton_clicked(bool checked)
     if (!_loadingPreset) presetsBox->setCurrentIndex(0);
 }
 
+void OutputWidget::on_segmentsButton_toggled(bool checked)
+{
+    segmentsEdit->setEnabled(checked);
+    if (!_loadingPreset) presetsBox->setCurrentIndex(0);
+}
+
+void OutputWidget::on_segmentsEdit_valueChanged(int arg1)
+{
+    Q_UNUSED(arg1);
+    if (!_loadingPreset) presetsBox->setCurrentIndex(0);
+}
+
+void OutputWidget::on_compressionButton_toggled(bool checked)
+{
+    compressionEdit->setEnabled(checked);
+    if (!_loadingPreset) presetsBox->setCurrentIndex(0);
+}
+
+void OutputWidget::on_predictionButton_toggled(bool checked)
+{
+    predictionBox->setEnabled(checked);
+    if (!_loadingPreset) presetsBox->setCurrentIndex(0);
+}
+
+void OutputWidget::on_compressionMethodButton_toggled(bool checked)
+{
+    compressionMethodBox->setEnabled(checked);
+    if (!_loadingPreset) presetsBox->setCurrentIndex(0);
+}
+
+void OutputWidget::on_packingButton_toggled(bool checked)
+{
+    packingBox->setEnabled(checked);
+    if (!_loadingPreset) presetsBox->setCurrentIndex(0);
+}
+
 void OutputWidget::on_videoCodecsFilterBox_currentIndexChanged(int index)
 {
     ffmpeg_loadCodecs();
@@ -804,6 +912,18 @@ void OutputWidget::updateVideoOptions()
     //start number
     startNumberButton->hide();
     startNumberEdit->hide();
+    //segments
+    segmentsButton->hide();
+    segmentsEdit->hide();
+    //image compression
+    compressionButton->hide();
+    compressionEdit->hide();
+    predictionButton->hide();
+    predictionBox->hide();
+    compressionMethodButton->hide();
+    compressionMethodBox->hide();
+    packingButton->hide();
+    packingBox->hide();
     //frame rate
     frameRateButton->hide();
     frameRateBox->hide();
@@ -844,6 +964,8 @@ void OutputWidget::updateVideoOptions()
             frameRateBox->show();
             frameRateButton->show();
             frameRateEdit->show();
+            segmentsButton->show();
+            segmentsEdit->show();
         }
     }
 
@@ -861,12 +983,32 @@ void OutputWidget::updateVideoOptions()
             videoProfileButton->show();
             videoProfileBox->show();
         }
-        //h264
-        else if (codec->name() == "h264")
+        //h264, jpeg
+        else if (codec->name() == "h264" || codec->name() == "mjpeg")
         {
             videoQualityButton->show();
             videoQualityWidget->show();
         }
+        //png
+        else if (codec->name() == "png")
+        {
+            compressionButton->show();
+            compressionEdit->show();
+            predictionButton->show();
+            predictionBox->show();
+        }
+        //tiff
+        else if (codec->name() == "tiff")
+        {
+            compressionMethodButton->show();
+            compressionMethodBox->show();
+        }
+        //dpx
+        else if (codec->name() == "dpx")
+        {
+            packingButton->show();
+            packingBox->show();
+        }
         //gif
         else if (codec->name() == "gif")
         {
@@ -886,6 +1028,11 @@ void OutputWidget::updateVideoOptions()
     if (audioBitrateButton->isHidden()) audioBitrateButton->setChecked(false);
     if (frameRateButton->isHidden()) frameRateButton->setChecked(false);
     if (startNumberButton->isHidden()) startNumberButton->setChecked(false);
+    if (segmentsButton->isHidden()) segmentsButton->setChecked(false);
+    if (compressionButton->isHidden()) compressionButton->setChecked(false);
+    if (predictionButton->isHidden()) predictionButton->setChecked(false);
+    if (compressionMethodButton->isHidden()) compressionMethodButton->setChecked(false);
+    if (packingButton->isHidden()) packingButton->setChecked(false);
 
 }
 
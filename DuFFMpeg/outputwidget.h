@@ -58,6 +58,12 @@ private slots:
     void on_videoLoopsButton_toggled(bool checked);
     void on_videoLoopsEdit_valueChanged(int arg1);
     void on_startNumberButton_clicked(bool checked);
+    void on_segmentsButton_toggled(bool checked);
+    void on_segmentsEdit_valueChanged(int arg1);
+    void on_compressionButton_toggled(bool checked);
+    void on_predictionButton_toggled(bool checked);
+    void on_compressionMethodButton_toggled(bool checked);
+    void on_packingButton_toggled(bool checked);
 
 private:
     /**
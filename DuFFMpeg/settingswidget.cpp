@@ -9,6 +9,21 @@ SettingsWidget::SettingsWidget(QSettings *s,QWidget *parent) :
 
     ffmpegPathEdit->setText(settings->value("ffmpeg/path","ffmpeg.exe").toString());
     userPresetsPathEdit->setText(settings->value("presets/path","").toString());
+    maxJobsEdit->setValue(settings->value("ffmpeg/maxJobs",1).toInt());
+    memoryBudgetEdit->setValue(settings->value("ffmpeg/memoryBudget",0).toInt());
+    outputBufferEdit->setValue(settings->value("ffmpeg/outputBuffer",1024).toInt());
+    jobLogsPathEdit->setText(settings->value("ffmpeg/logsPath","").toString());
+    progressRateEdit->setValue(settings->value("ffmpeg/progressRate",8).toInt());
+    logsMaxSizeEdit->setValue(settings->value("ffmpeg/logsMaxSize",10).toInt());
+    metricsPortEdit->setValue(settings->value("ffmpeg/metricsPort",0).toInt());
+    benchmarkBox->setChecked(settings->value("ffmpeg/benchmark",false).toBool());
+    followCompletionBox->setCurrentIndex(settings->value("ffmpeg/followCompletion",0).toInt());
+    followTimeoutEdit->setValue(settings->value("ffmpeg/followTimeout",60).toInt());
+    prefetchThreadsEdit->setValue(settings->value("ffmpeg/prefetchThreads",0).toInt());
+    prefetchDepthEdit->setValue(settings->value("ffmpeg/prefetchDepth",16).toInt());
+    cacheBudgetEdit->setValue(settings->value("ffmpeg/cacheBudget",0).toInt());
+    batchProcessesEdit->setValue(settings->value("ffmpeg/batchProcesses",1).toInt());
+    mezzaninePathEdit->setText(settings->value("ffmpeg/mezzaninePath","").toString());
 }
 
 void SettingsWidget::on_ffmpegBrowseButton_clicked()
@@ -42,3 +57,115 @@ void SettingsWidget::on_userPresetsPathEdit_editingFinished()
     settings->setValue("presets/path",userPresetsPathEdit->text());
     emit presetsPathChanged(userPresetsPathEdit->text());
 }
+
+void SettingsWidget::on_maxJobsEdit_valueChanged(int arg1)
+{
+    settings->setValue("ffmpeg/maxJobs",arg1);
+    emit maxJobsChanged(arg1);
+}
+
+void SettingsWidget::on_memoryBudgetEdit_valueChanged(int arg1)
+{
+    //in MB in the settings
+    settings->setValue("ffmpeg/memoryBudget",arg1);
+    emit memoryBudgetChanged(qint64(arg1)*1024*1024);
+}
+
+void SettingsWidget::on_outputBufferEdit_valueChanged(int arg1)
+{
+    //in KB in the settings
+    settings->setValue("ffmpeg/outputBuffer",arg1);
+    emit outputBufferSizeChanged(arg1*1024);
+}
+
+void SettingsWidget::on_jobLogsBrowseButton_clicked()
+{
+    QString path = QFileDialog::getExistingDirectory(this,"Select the folder where the encoding logs are written",settings->value("ffmpeg/logsPath").toString());
+    if (path == "") return;
+    jobLogsPathEdit->setText(path);
+    settings->setValue("ffmpeg/logsPath",path);
+    emit jobLogsPathChanged(path);
+}
+
+void SettingsWidget::on_jobLogsPathEdit_editingFinished()
+{
+    settings->setValue("ffmpeg/logsPath",jobLogsPathEdit->text());
+    emit jobLogsPathChanged(jobLogsPathEdit->text());
+}
+
+void SettingsWidget::on_progressRateEdit_valueChanged(int arg1)
+{
+    settings->setValue("ffmpeg/progressRate",arg1);
+    emit progressRateChanged(arg1);
+}
+
+void SettingsWidget::on_logsMaxSizeEdit_valueChanged(int arg1)
+{
+    //in MB in the settings
+    settings->setValue("ffmpeg/logsMaxSize",arg1);
+    emit logsMaxSizeChanged(qint64(arg1)*1024*1024);
+}
+
+void SettingsWidget::on_metricsPortEdit_valueChanged(int arg1)
+{
+    settings->setValue("ffmpeg/metricsPort",arg1);
+    emit metricsPortChanged(arg1);
+}
+
+void SettingsWidget::on_benchmarkBox_toggled(bool checked)
+{
+    settings->setValue("ffmpeg/benchmark",checked);
+    emit benchmarkChanged(checked);
+}
+
+void SettingsWidget::on_followCompletionBox_currentIndexChanged(int index)
+{
+    settings->setValue("ffmpeg/followCompletion",index);
+    emit followCompletionChanged(index);
+}
+
+void SettingsWidget::on_followTimeoutEdit_valueChanged(int arg1)
+{
+    settings->setValue("ffmpeg/followTimeout",arg1);
+    emit followTimeoutChanged(arg1);
+}
+
+void SettingsWidget::on_prefetchThreadsEdit_valueChanged(int arg1)
+{
+    settings->setValue("ffmpeg/prefetchThreads",arg1);
+    emit prefetchThreadsChanged(arg1);
+}
+
+void SettingsWidget::on_prefetchDepthEdit_valueChanged(int arg1)
+{
+    settings->setValue("ffmpeg/prefetchDepth",arg1);
+    emit prefetchDepthChanged(arg1);
+}
+
+void SettingsWidget::on_cacheBudgetEdit_valueChanged(int arg1)
+{
+    //in MB in the settings
+    settings->setValue("ffmpeg/cacheBudget",arg1);
+    emit cacheBudgetChanged(qint64(arg1)*1024*1024);
+}
+
+void SettingsWidget::on_batchProcessesEdit_valueChanged(int arg1)
+{
+    settings->setValue("ffmpeg/batchProcesses",arg1);
+    emit batchProcessesChanged(arg1);
+}
+
+void SettingsWidget::on_mezzanineBrowseButton_clicked()
+{
+    QString path = QFileDialog::getExistingDirectory(this,"Select the folder of the mezzanine cache",settings->value("ffmpeg/mezzaninePath").toString());
+    if (path == "") return;
+    mezzaninePathEdit->setText(path);
+    settings->setValue("ffmpeg/mezzaninePath",path);
+    emit mezzaninePathChanged(path);
+}
+
+void SettingsWidget::on_mezzaninePathEdit_editingFinished()
+{
+    settings->setValue("ffmpeg/mezzaninePath",mezzaninePathEdit->text());
+    emit mezzaninePathChanged(mezzaninePathEdit->text());
+}
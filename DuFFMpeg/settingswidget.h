@@ -16,6 +16,21 @@ public:
 signals:
     void ffmpegPathChanged(QString);
     void presetsPathChanged(QString);
+    void maxJobsChanged(int);
+    void memoryBudgetChanged(qint64);
+    void outputBufferSizeChanged(int);
+    void jobLogsPathChanged(QString);
+    void progressRateChanged(int);
+    void logsMaxSizeChanged(qint64);
+    void metricsPortChanged(int);
+    void benchmarkChanged(bool);
+    void followCompletionChanged(int);
+    void followTimeoutChanged(int);
+    void prefetchThreadsChanged(int);
+    void prefetchDepthChanged(int);
+    void cacheBudgetChanged(qint64);
+    void batchProcessesChanged(int);
+    void mezzaninePathChanged(QString);
 
 private slots:
     void on_ffmpegBrowseButton_clicked();
@@ -24,6 +39,23 @@ private slots:
     void on_userPresetsBrowseButton_clicked();
 
     void on_userPresetsPathEdit_editingFinished();
+    void on_maxJobsEdit_valueChanged(int arg1);
+    void on_memoryBudgetEdit_valueChanged(int arg1);
+    void on_outputBufferEdit_valueChanged(int arg1);
+    void on_jobLogsBrowseButton_clicked();
+    void on_jobLogsPathEdit_editingFinished();
+    void on_progressRateEdit_valueChanged(int arg1);
+    void on_logsMaxSizeEdit_valueChanged(int arg1);
+    void on_metricsPortEdit_valueChanged(int arg1);
+    void on_benchmarkBox_toggled(bool checked);
+    void on_followCompletionBox_currentIndexChanged(int index);
+    void on_followTimeoutEdit_valueChanged(int arg1);
+    void on_prefetchThreadsEdit_valueChanged(int arg1);
+    void on_prefetchDepthEdit_valueChanged(int arg1);
+    void on_cacheBudgetEdit_valueChanged(int arg1);
+    void on_batchProcessesEdit_valueChanged(int arg1);
+    void on_mezzanineBrowseButton_clicked();
+    void on_mezzaninePathEdit_editingFinished();
 private:
     QSettings *settings;
 
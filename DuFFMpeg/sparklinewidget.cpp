@@ -0,0 +1,63 @@
+#include "sparklinewidget.h"
+
+SparklineWidget::SparklineWidget(QWidget *parent) :
+    QWidget(parent)
+{
+    _minimum = 0.0;
+    _maximum = 0.0;
+    setMinimumSize(60,16);
+    setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Fixed);
+}
+
+QSize SparklineWidget::sizeHint() const
+{
+    return QSize(200,20);
+}
+
+void SparklineWidget::setValues(QList<double> values)
+{
+    _values = values;
+    _minimum = 0.0;
+    _maximum = 0.0;
+    if (_values.count() > 0)
+    {
+        _minimum = *std::min_element(_values.begin(),_values.end());
+        _maximum = *std::max_element(_values.begin(),_values.end());
+        setToolTip("Min: " + QString::number(_minimum) + " | Max: " + QString::number(_maximum) + " | Last: " + QString::number(_values.last()));
+    }
+    else setToolTip("");
+    update();
+}
+
+void SparklineWidget::clear()
+{
+    setValues(QList<double>());
+}
+
+void SparklineWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    if (_values.count() < 2) return;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(palette().color(QPalette::Highlight),1.5));
+
+    QRectF area = QRectF(rect()).adjusted(1,2,-1,-2);
+    double range = _maximum - _minimum;
+    double step = area.width() / (_values.count() - 1);
+
+    //a point per pixel at most is enough
+    int stride = qMax(1,int(_values.count() / qMax(1.0,area.width())));
+
+    QPainterPath path;
+    for (int i = 0 ; i < _values.count() ; i += stride)
+    {
+        double y = area.center().y();
+        if (range > 0) y = area.bottom() - (_values.at(i) - _minimum) / range * area.height();
+        QPointF point(area.left() + i * step,y);
+        if (i == 0) path.moveTo(point);
+        else path.lineTo(point);
+    }
+    painter.drawPath(path);
+}
@@ -0,0 +1,38 @@
+#ifndef SPARKLINEWIDGET_H
+#define SPARKLINEWIDGET_H
+
+#include <QWidget>
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+
+/**
+ * @brief The SparklineWidget class Draws a series of values as a small line chart, scaled between its minimum and its maximum
+ */
+class SparklineWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SparklineWidget(QWidget *parent = 0);
+
+    QSize sizeHint() const;
+
+public slots:
+    /**
+     * @brief setValues Sets the series to draw
+     * @param values The values, in order
+     */
+    void setValues(QList<double> values);
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event);
+
+private:
+    QList<double> _values;
+    double _minimum;
+    double _maximum;
+};
+
+#endif // SPARKLINEWIDGET_H